@@ -0,0 +1,37 @@
+// Shared helpers for the micro-benchmarks, one program per feature, all against the noop backend.
+// Each program is a unity build of portal.c, build from the repository root:
+// cc -O2 -pthread -I. bench/bench_queue.c portal_noop.c -o bench_queue && ./bench_queue
+// Add -DPT_DIRECT_DISPATCH -flto to measure compile-time backend dispatch,
+// and -DPT_ASSERT_LEVEL=0, 1 or 2 to compare push cost per assertion level.
+// Correctness checks live in test.c, these only report numbers.
+#ifndef PT_BENCH_H
+#define PT_BENCH_H
+
+#include "portal.c"
+#include <pthread.h>
+#include <sched.h>
+
+#define BENCH_ROUNDS 20000
+
+static volatile int bench_sink = 0;
+
+static inline double bench_now_ns() {
+    return pt_get_time() * 1000000000.0;
+}
+
+static inline void bench_fill(PtWindow *window, int count) {
+    for (int e = 0; e < count; e++) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = PT_INPUT_EVENT_MOUSEMOVE;
+        event.mouse.x = e;
+        pt_push_input_event(window, event);
+    }
+}
+
+static inline int bench_compare_i64(const void *a, const void *b) {
+    int64_t x = *(const int64_t*)a;
+    int64_t y = *(const int64_t*)b;
+    return (x > y) - (x < y);
+}
+
+#endif
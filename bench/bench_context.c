@@ -0,0 +1,163 @@
+// Instance benchmarks: backend dispatch, pooled window creation and independent contexts on threads.
+#include "bench.h"
+
+#define BENCH_DISPATCH_CALLS 10000000
+
+static void bench_dispatch(PtWindow *window) {
+    int (*volatile get_width)(PtWindow*) = pt_noop_get_window_width;
+
+    #ifdef PT_DIRECT_DISPATCH
+    printf("dispatch (PT_DIRECT_DISPATCH)\n");
+    #else
+    printf("dispatch (function pointer table)\n");
+    #endif
+
+    double start = bench_now_ns();
+    for (int i = 0; i < BENCH_DISPATCH_CALLS; i++) {
+        bench_sink += pt_get_window_width(window);
+    }
+    double api = (bench_now_ns() - start) / BENCH_DISPATCH_CALLS;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_DISPATCH_CALLS; i++) {
+        bench_sink += get_width(window);
+    }
+    double indirect = (bench_now_ns() - start) / BENCH_DISPATCH_CALLS;
+
+    start = bench_now_ns();
+    for (int i = 0; i < BENCH_DISPATCH_CALLS; i++) {
+        bench_sink += pt_noop_get_window_width(window);
+    }
+    double direct = (bench_now_ns() - start) / BENCH_DISPATCH_CALLS;
+
+    printf("  pt_get_window_width %6.2f ns/call\n", api);
+    printf("  indirect call       %6.2f ns/call\n", indirect);
+    printf("  direct call         %6.2f ns/call\n", direct);
+}
+
+typedef struct BenchAllocatorStats {
+    long long live_bytes;
+    int alloc_count;
+} BenchAllocatorStats;
+
+static void *bench_alloc(size_t size, void *user_data) {
+    BenchAllocatorStats *stats = (BenchAllocatorStats*)user_data;
+    stats->alloc_count++;
+    stats->live_bytes += (long long)size;
+    return malloc(size);
+}
+
+static void bench_free(void *ptr, size_t size, void *user_data) {
+    BenchAllocatorStats *stats = (BenchAllocatorStats*)user_data;
+    stats->live_bytes -= (long long)size;
+    free(ptr);
+}
+
+static void bench_window_pool(BenchAllocatorStats *stats) {
+    int cycles = 10000;
+    int alloc_count = stats->alloc_count;
+
+    printf("window create/destroy, pooled window and handle block\n");
+    double start = bench_now_ns();
+    for (int i = 0; i < cycles; i++) {
+        pt_destroy_window(pt_create_window("bench pool", 0, 0, PT_FLAG_NONE));
+    }
+    double elapsed = bench_now_ns() - start;
+
+    printf("  %8.1f ns/cycle, %.1f allocations/cycle\n", elapsed / cycles, (double)(stats->alloc_count - alloc_count) / cycles);
+}
+
+#define BENCH_CONTEXT_COUNT 4
+#define BENCH_CONTEXT_FRAMES 20000
+
+typedef struct BenchContextRun {
+    long long events;
+    PT_BOOL ok;
+} BenchContextRun;
+
+// each thread owns a full noop instance, nothing is shared with the other threads
+static void *bench_context_thread(void *arg) {
+    BenchContextRun *run = (BenchContextRun*)arg;
+
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    PtContext *context = pt_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "bench context", 0, 0, PT_FLAG_NONE);
+
+    run->ok = pt_get_window_context(window) == context;
+    for (int frame = 0; frame < BENCH_CONTEXT_FRAMES; frame++) {
+        pt_poll_events(window);
+
+        for (int e = 0; e < 8; e++) {
+            PtInputEventData event = pt_create_input_event_data();
+            event.type = PT_INPUT_EVENT_KEYDOWN;
+            event.key.key = e;
+            pt_push_input_event(window, event);
+        }
+
+        while (pt_get_input_event_count(window) > 0) {
+            pt_pull_input_event(window);
+            run->events++;
+        }
+
+        pt_swap_buffers(window);
+    }
+
+    run->ok = run->ok && run->events == (long long)BENCH_CONTEXT_FRAMES * 8;
+
+    pt_destroy_window(window);
+    pt_destroy_context(context);
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return NULL;
+}
+
+static void bench_contexts() {
+    pthread_t threads[BENCH_CONTEXT_COUNT];
+    BenchContextRun runs[BENCH_CONTEXT_COUNT];
+    PT_BOOL ok = PT_TRUE;
+
+    printf("independent contexts, one per thread\n");
+    double start = bench_now_ns();
+    for (int i = 0; i < BENCH_CONTEXT_COUNT; i++) {
+        runs[i].events = 0;
+        runs[i].ok = PT_FALSE;
+        pthread_create(&threads[i], NULL, bench_context_thread, &runs[i]);
+    }
+
+    for (int i = 0; i < BENCH_CONTEXT_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        ok = ok && runs[i].ok;
+    }
+    double elapsed = bench_now_ns() - start;
+
+    printf("  %d contexts x %d frames in %.1f ms, %s\n", BENCH_CONTEXT_COUNT, BENCH_CONTEXT_FRAMES, elapsed / 1000000.0, ok ? "all events delivered" : "events lost");
+}
+
+int main() {
+    BenchAllocatorStats allocator_stats = { 0, 0 };
+
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    config->allocator.alloc = bench_alloc;
+    config->allocator.free = bench_free;
+    config->allocator.user_data = &allocator_stats;
+
+    if (!pt_init(config)) {
+        return 1;
+    }
+
+    PtWindow *window = pt_create_window("bench context", 0, 0, PT_FLAG_NONE);
+
+    bench_dispatch(window);
+    bench_window_pool(&allocator_stats);
+    bench_contexts();
+
+    pt_destroy_window(window);
+    pt_shutdown();
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return 0;
+}
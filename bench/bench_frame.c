@@ -0,0 +1,179 @@
+// Frame pacing benchmarks: sleep accuracy, deadline scheduling, frame stats and background throttling.
+#include "bench.h"
+
+#define BENCH_SLEEP_ROUNDS 200
+
+static void bench_sleep_report(const char *label, int64_t *late) {
+    qsort(late, BENCH_SLEEP_ROUNDS, sizeof(int64_t), bench_compare_i64);
+    printf("  %-22s p50 %7.1f us  p99 %7.1f us  max %7.1f us\n", label,
+        late[BENCH_SLEEP_ROUNDS / 2] / 1000.0,
+        late[BENCH_SLEEP_ROUNDS * 99 / 100] / 1000.0,
+        late[BENCH_SLEEP_ROUNDS - 1] / 1000.0);
+}
+
+static void bench_sleep() {
+    int64_t durations[] = { 1000000, 4000000 };
+    int64_t late[BENCH_SLEEP_ROUNDS];
+
+    printf("sleep deadline error, spin margin %.1f us\n", pt_calibrate_sleep() / 1000.0);
+    for (int i = 0; i < PT_TABLE_SIZE(durations); i++) {
+        char label[64];
+
+        for (int round = 0; round < BENCH_SLEEP_ROUNDS; round++) {
+            int64_t deadline = pt_get_time_ns() + durations[i];
+            struct timespec ts = { 0, (long)durations[i] };
+            nanosleep(&ts, NULL);
+            late[round] = pt_get_time_ns() - deadline;
+        }
+        snprintf(label, sizeof(label), "nanosleep %d ms", (int)(durations[i] / 1000000));
+        bench_sleep_report(label, late);
+
+        for (int round = 0; round < BENCH_SLEEP_ROUNDS; round++) {
+            int64_t deadline = pt_get_time_ns() + durations[i];
+            pt_sleep_until_ns(deadline);
+            late[round] = pt_get_time_ns() - deadline;
+        }
+        snprintf(label, sizeof(label), "pt_sleep_until_ns %d ms", (int)(durations[i] / 1000000));
+        bench_sleep_report(label, late);
+    }
+}
+
+#define BENCH_SCHEDULE_FRAMES 100000
+#define BENCH_SCHEDULE_DURATION (1000000000LL / 60)
+
+static uint32_t bench_random_state = 12345;
+
+static int64_t bench_random(int64_t range) {
+    bench_random_state = bench_random_state * 1664525u + 1013904223u;
+    return (int64_t)(bench_random_state >> 8) % range;
+}
+
+// Frames on a simulated clock: 8-14 ms of work, and every sleep wakes up to 500 us late.
+// overrun_every > 0 makes every nth frame take 40 ms.
+static int64_t bench_schedule_run(PtFrameOverrunPolicy policy, int overrun_every, PT_BOOL legacy, int64_t *end_time) {
+    int64_t now = 0;
+    int64_t deadline = BENCH_SCHEDULE_DURATION;
+
+    for (int frame = 1; frame <= BENCH_SCHEDULE_FRAMES; frame++) {
+        now += (overrun_every > 0 && frame % overrun_every == 0) ? 40000000 : 8000000 + bench_random(6000000);
+
+        if (now < deadline) {
+            now = deadline + bench_random(500000);
+        }
+
+        // the old scheduler measured the next frame from the wake-up time
+        deadline = legacy ? now + BENCH_SCHEDULE_DURATION : pt_next_frame_deadline(deadline, BENCH_SCHEDULE_DURATION, now, policy);
+    }
+
+    *end_time = now;
+    return deadline;
+}
+
+static void bench_schedule() {
+    int64_t ideal = (int64_t)(BENCH_SCHEDULE_FRAMES + 1) * BENCH_SCHEDULE_DURATION;
+    int64_t end_time;
+
+    printf("frame scheduling, %d frames at 60 fps on a simulated clock\n", BENCH_SCHEDULE_FRAMES);
+
+    int64_t legacy = bench_schedule_run(PT_FRAME_OVERRUN_CATCH_UP, 0, PT_TRUE, &end_time);
+    printf("  from wake-up time      deadline drift %10.3f ms\n", (legacy - ideal) / 1000000.0);
+
+    int64_t deadline = bench_schedule_run(PT_FRAME_OVERRUN_CATCH_UP, 0, PT_FALSE, &end_time);
+    printf("  absolute deadlines     deadline drift %10.3f ms, last wake-up %.3f ms late\n", (deadline - ideal) / 1000000.0, (end_time - (ideal - BENCH_SCHEDULE_DURATION)) / 1000000.0);
+
+    deadline = bench_schedule_run(PT_FRAME_OVERRUN_SKIP, 100, PT_FALSE, &end_time);
+    printf("  skip, 1%% overruns      %lld frame slots skipped, deadlines %s the frame grid\n",
+        (long long)(deadline / BENCH_SCHEDULE_DURATION - (BENCH_SCHEDULE_FRAMES + 1)), deadline % BENCH_SCHEDULE_DURATION == 0 ? "on" : "OFF");
+
+    deadline = bench_schedule_run(PT_FRAME_OVERRUN_CATCH_UP, 100, PT_FALSE, &end_time);
+    printf("  catch up, 1%% overruns  deadline drift %10.3f ms\n", (deadline - ideal) / 1000000.0);
+}
+
+static void bench_frame_stats(PtWindow *window) {
+    int swaps = 1000000;
+    PtFrameTimings timings;
+    PtFrameStats stats;
+
+    printf("frame stats\n");
+    PT_MEMSET(&timings, 0, sizeof(timings));
+    double start = bench_now_ns();
+    for (int i = 1; i <= swaps; i++) {
+        pt_record_frame_timing(&timings, i * 1000, i * 1000 + 100);
+    }
+    bench_sink += (int)timings.count;
+    printf("  record            %6.2f ns/frame\n", (bench_now_ns() - start) / swaps);
+
+    start = bench_now_ns();
+    for (int i = 0; i < swaps; i++) {
+        pt_swap_buffers(window);
+    }
+    printf("  noop swap         %6.2f ns/frame, timing included\n", (bench_now_ns() - start) / swaps);
+
+    pt_enable_throttle(window, 240);
+    pt_reset_frame_stats(window);
+    for (int i = 0; i < 120; i++) {
+        pt_swap_buffers(window);
+    }
+    pt_disable_throttle(window);
+
+    pt_get_frame_stats(window, &stats);
+    printf("  240 fps throttle  %d frames, mean %.3f ms, p50 %.3f ms, p99 %.3f ms, max %.3f ms, %d missed\n",
+        stats.count, stats.mean * 1000.0, stats.p50 * 1000.0, stats.p99 * 1000.0, stats.max * 1000.0, stats.missed_count);
+}
+
+static void bench_background() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    config->background_policy = PT_BACKGROUND_THROTTLE;
+    config->background_fps = 100;
+
+    PtContext *context = pt_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "bench background", 0, 0, PT_FLAG_NONE);
+    PtFrameStats foreground;
+    PtFrameStats background;
+
+    printf("background throttling at 100 fps\n");
+    for (int i = 0; i < 20; i++) {
+        pt_swap_buffers(window);
+    }
+    pt_get_frame_stats(window, &foreground);
+
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, PT_TRUE);
+    pt_reset_frame_stats(window);
+    for (int i = 0; i < 20; i++) {
+        pt_swap_buffers(window);
+    }
+    pt_get_frame_stats(window, &background);
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, PT_FALSE);
+
+    printf("  foreground p50 %8.3f ms\n", foreground.p50 * 1000.0);
+    printf("  minimized  p50 %8.3f ms\n", background.p50 * 1000.0);
+
+    pt_destroy_window(window);
+    pt_destroy_context(context);
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+}
+
+int main() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+
+    if (!pt_init(config)) {
+        return 1;
+    }
+
+    PtWindow *window = pt_create_window("bench frame", 0, 0, PT_FLAG_NONE);
+
+    bench_sleep();
+    bench_schedule();
+    bench_frame_stats(window);
+    bench_background();
+
+    pt_destroy_window(window);
+    pt_shutdown();
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return 0;
+}
@@ -0,0 +1,201 @@
+// Input latency benchmarks: latency stats overhead, recording replay and the late poll frame mode.
+#include "bench.h"
+
+static void bench_latency_stats(PtWindow *window) {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    double totals[2] = { 0.0, 0.0 };
+
+    for (int enabled = 0; enabled < 2; enabled++) {
+        if (enabled) {
+            pt_enable_latency_stats(window);
+        }
+
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            int64_t captured = pt_get_time_ns();
+            for (int e = 0; e < PT_MAX_EVENT_COUNT; e++) {
+                PtInputEventData event = pt_create_input_event_data();
+                event.type = PT_INPUT_EVENT_MOUSEMOVE;
+                event.timestamp = captured;
+                pt_push_input_event(window, event);
+            }
+
+            double start = bench_now_ns();
+            bench_sink += pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+            totals[enabled] += bench_now_ns() - start;
+            pt_swap_buffers(window);
+        }
+    }
+
+    PtLatencyStats stats;
+    pt_get_latency_stats(window, PT_LATENCY_CAPTURE_TO_PULL, &stats);
+    pt_disable_latency_stats(window);
+
+    double events = (double)BENCH_ROUNDS * PT_MAX_EVENT_COUNT;
+    printf("latency stats, pull all\n");
+    printf("  off: %6.2f ns/event\n", totals[0] / events);
+    printf("  on:  %6.2f ns/event, capture to pull p50 %.1f us, p99 %.1f us over %d events\n",
+        totals[1] / events, stats.p50 * 1000000.0, stats.p99 * 1000000.0, stats.count);
+}
+
+#define BENCH_REPLAY_EVENTS 1000000
+
+// records a synthetic session, then replays it as fast as possible through the noop backend
+static void bench_replay(PtWindow *window) {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    const char *path = "bench_input.ptir";
+
+    if (!pt_start_input_recording(window, path)) {
+        printf("replay: could not write %s\n", path);
+        return;
+    }
+
+    for (int e = 0; e < BENCH_REPLAY_EVENTS; e++) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = e % 64 == 0 ? PT_INPUT_EVENT_KEYDOWN : PT_INPUT_EVENT_MOUSEMOVE;
+        event.mouse.x = e;
+        event.timestamp = (int64_t)e * 1000000;
+        pt_push_input_event(window, event);
+
+        if (pt_get_input_event_count(window) == PT_MAX_EVENT_COUNT) {
+            pt_skip_input_events(window, PT_MAX_EVENT_COUNT);
+        }
+    }
+
+    pt_stop_input_recording(window);
+    pt_skip_input_events(window, pt_get_input_event_count(window));
+
+    int replayed = 0;
+    double start = bench_now_ns();
+    pt_noop_start_replay(window, path, PT_REPLAY_AS_FAST_AS_POSSIBLE);
+    while (pt_noop_is_replaying(window)) {
+        pt_poll_events(window);
+        int count = pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+        for (int e = 0; e < count; e++) {
+            bench_sink += out[e].mouse.x;
+        }
+        replayed += count;
+    }
+    double total = bench_now_ns() - start;
+    pt_noop_stop_replay(window);
+    remove(path);
+
+    printf("replay, as fast as possible\n");
+    printf("  %d of %d events, %6.2f ns/event, %d bytes/event on disk\n",
+        replayed, BENCH_REPLAY_EVENTS, total / replayed, (int)sizeof(PtInputEventData));
+}
+
+#define BENCH_LATE_POLL_FRAMES 100
+#define BENCH_LATE_POLL_WARMUP 10
+#define BENCH_LATE_POLL_RENDER_NS 2000000
+
+typedef struct BenchLatePollRun {
+    PtWindow *window;
+    _Atomic int stop;
+} BenchLatePollRun;
+
+// mouse moves every 250 us, about what a high rate mouse delivers
+static void *bench_late_poll_producer(void *arg) {
+    BenchLatePollRun *run = (BenchLatePollRun*)arg;
+
+    while (!atomic_load(&run->stop)) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = PT_INPUT_EVENT_MOUSEMOVE;
+        event.timestamp = pt_get_time_ns();
+        pt_push_input_event(run->window, event);
+        pt_sleep(0.00025);
+    }
+
+    return NULL;
+}
+
+// Runs a 100 fps loop with 2 ms of render work and returns the mean input to present latency in nanoseconds.
+static double bench_late_poll_run(PtWindow *window, PT_BOOL late_poll, int64_t *latency, int *latency_count) {
+    static PtInputEventData events[PT_MAX_EVENT_COUNT];
+    BenchLatePollRun run;
+    pthread_t producer;
+    double total = 0.0;
+
+    run.window = window;
+    atomic_init(&run.stop, 0);
+    *latency_count = 0;
+
+    pt_enable_throttle(window, 100);
+    pt_set_late_poll(window, late_poll);
+    pthread_create(&producer, NULL, bench_late_poll_producer, &run);
+
+    for (int frame = 0; frame < BENCH_LATE_POLL_FRAMES; frame++) {
+        pt_poll_events(window);
+        int count = pt_pull_input_events(window, events, PT_MAX_EVENT_COUNT);
+
+        int64_t render_end = pt_get_time_ns() + BENCH_LATE_POLL_RENDER_NS;
+        while (pt_get_time_ns() < render_end) {
+            PT_CPU_RELAX();
+        }
+
+        pt_swap_buffers(window);
+        int64_t present = pt_get_time_ns();
+
+        for (int e = 0; e < count && frame >= BENCH_LATE_POLL_WARMUP && *latency_count < BENCH_LATE_POLL_FRAMES * 64; e++) {
+            latency[*latency_count] = present - events[e].timestamp;
+            total += latency[*latency_count];
+            (*latency_count)++;
+        }
+    }
+
+    atomic_store(&run.stop, 1);
+    pthread_join(producer, NULL);
+    pt_disable_throttle(window);
+    pt_pull_input_events(window, events, PT_MAX_EVENT_COUNT);
+
+    return *latency_count > 0 ? total / *latency_count : 0.0;
+}
+
+static void bench_late_poll() {
+    static int64_t latency[BENCH_LATE_POLL_FRAMES * 64];
+    int count;
+
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    config->concurrent_event_queue = PT_TRUE;
+
+    PtContext *context = pt_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "bench late poll", 0, 0, PT_FLAG_NONE);
+
+    printf("late poll, 100 fps with 2 ms render, input to present latency\n");
+
+    double sleep_in_swap = bench_late_poll_run(window, PT_FALSE, latency, &count);
+    qsort(latency, count, sizeof(int64_t), bench_compare_i64);
+    printf("  sleep in swap  mean %6.2f ms, p99 %6.2f ms\n", sleep_in_swap / 1000000.0, latency[count * 99 / 100] / 1000000.0);
+
+    double late_poll = bench_late_poll_run(window, PT_TRUE, latency, &count);
+    qsort(latency, count, sizeof(int64_t), bench_compare_i64);
+    printf("  late poll      mean %6.2f ms, p99 %6.2f ms, render cost %.2f ms\n", late_poll / 1000000.0, latency[count * 99 / 100] / 1000000.0, pt_get_render_cost(window) * 1000.0);
+    pt_set_late_poll(window, PT_FALSE);
+
+    pt_destroy_window(window);
+    pt_destroy_context(context);
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+}
+
+int main() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+
+    if (!pt_init(config)) {
+        return 1;
+    }
+
+    PtWindow *window = pt_create_window("bench latency", 0, 0, PT_FLAG_NONE);
+
+    bench_latency_stats(window);
+    bench_replay(window);
+    bench_late_poll();
+
+    pt_destroy_window(window);
+    pt_shutdown();
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return 0;
+}
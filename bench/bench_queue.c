@@ -0,0 +1,351 @@
+// Event queue benchmarks: drain, push, batch pulls, event layout, overflow handling, input state and spsc.
+#include "bench.h"
+
+static void bench_drain(PtWindow *window) {
+    int fill_levels[] = { 1, 16, 64, 128, PT_MAX_EVENT_COUNT };
+
+    printf("drain (pt_pull_input_event)\n");
+    for (int i = 0; i < PT_TABLE_SIZE(fill_levels); i++) {
+        int fill = fill_levels[i];
+        double total = 0.0;
+
+        for (int round = 0; round < BENCH_ROUNDS; round++) {
+            bench_fill(window, fill);
+
+            double start = bench_now_ns();
+            while (pt_get_input_event_count(window) > 0) {
+                bench_sink += pt_pull_input_event(window).mouse.x;
+            }
+            total += bench_now_ns() - start;
+        }
+
+        printf("  fill %3d: %6.2f ns/event\n", fill, total / ((double)BENCH_ROUNDS * fill));
+    }
+}
+
+static void bench_push(PtWindow *window) {
+    int capacity = pt_get_input_event_capacity(window);
+    PtInputEventData event = pt_create_input_event_data();
+    event.type = PT_INPUT_EVENT_MOUSEMOVE;
+    double total = 0.0;
+
+    printf("push (PT_ASSERT_LEVEL %d)\n", PT_ASSERT_LEVEL);
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        double start = bench_now_ns();
+        for (int e = 0; e < capacity; e++) {
+            event.mouse.x = e;
+            pt_push_input_event(window, event);
+        }
+        total += bench_now_ns() - start;
+
+        pt_skip_input_events(window, capacity);
+    }
+
+    printf("  %6.2f ns/event\n", total / ((double)BENCH_ROUNDS * capacity));
+}
+
+static void bench_batch_drain(PtWindow *window) {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    double single = 0.0, batch = 0.0, peek = 0.0;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        bench_fill(window, PT_MAX_EVENT_COUNT);
+        double start = bench_now_ns();
+        while (pt_get_input_event_count(window) > 0) {
+            bench_sink += pt_pull_input_event(window).mouse.x;
+        }
+        single += bench_now_ns() - start;
+
+        bench_fill(window, PT_MAX_EVENT_COUNT);
+        start = bench_now_ns();
+        int count = pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+        for (int e = 0; e < count; e++) {
+            bench_sink += out[e].mouse.x;
+        }
+        batch += bench_now_ns() - start;
+
+        bench_fill(window, PT_MAX_EVENT_COUNT);
+        start = bench_now_ns();
+        const PtInputEventData *events;
+        while ((count = pt_peek_input_events(window, &events)) > 0) {
+            for (int e = 0; e < count; e++) {
+                bench_sink += events[e].mouse.x;
+            }
+            pt_skip_input_events(window, count);
+        }
+        peek += bench_now_ns() - start;
+    }
+
+    double events = (double)BENCH_ROUNDS * PT_MAX_EVENT_COUNT;
+    printf("full drain, %d events\n", PT_MAX_EVENT_COUNT);
+    printf("  pull one: %6.2f ns/event\n", single / events);
+    printf("  pull all: %6.2f ns/event\n", batch / events);
+    printf("  peek:     %6.2f ns/event\n", peek / events);
+}
+
+// PtInputEventData as it was before the payloads shared storage
+typedef struct {
+    PtInputEventType type;
+    PtInputEventKeyData key;
+    struct { int button, modifiers, x, y, dx, dy; } mouse;
+    PtInputEventTouchData touch;
+    PtInputEventTextData text;
+    double timestamp;
+} BenchLegacyEventData;
+
+static BenchLegacyEventData bench_legacy_create() {
+    BenchLegacyEventData event;
+
+    event.type = PT_INPUT_EVENT_NONE;
+    event.mouse.button = 0;
+    event.mouse.x = 0;
+    event.mouse.y = 0;
+    event.mouse.dx = 0;
+    event.mouse.dy = 0;
+    event.mouse.modifiers = 0;
+    event.key.key = 0;
+    event.key.modifiers = 0;
+    event.touch.finger = 0;
+    event.touch.x = 0;
+    event.touch.y = 0;
+    event.text.codepoint = 0;
+    event.timestamp = 0.0;
+
+    return event;
+}
+
+// the same ring as pt_push_input_event / pt_pull_input_event, only the element type differs.
+// kept out of line so events cross a call boundary by value, as they do through the library
+#define BENCH_RING(name, type, create) \
+    static type name##_events[PT_MAX_EVENT_COUNT]; \
+    static int name##_head = 0; \
+    static int name##_count = 0; \
+    static __attribute__((noinline)) void name##_push(type event) { \
+        if (name##_count >= PT_MAX_EVENT_COUNT) return; \
+        name##_events[(name##_head + name##_count) & (PT_MAX_EVENT_COUNT - 1)] = event; \
+        name##_count++; \
+    } \
+    static __attribute__((noinline)) type name##_pull() { \
+        if (name##_count == 0) return create(); \
+        type event = name##_events[name##_head]; \
+        name##_head = (name##_head + 1) & (PT_MAX_EVENT_COUNT - 1); \
+        name##_count--; \
+        return event; \
+    }
+
+BENCH_RING(bench_legacy, BenchLegacyEventData, bench_legacy_create)
+BENCH_RING(bench_compact, PtInputEventData, pt_create_input_event_data)
+
+static double bench_legacy_round() {
+    double start = bench_now_ns();
+    for (int e = 0; e < PT_MAX_EVENT_COUNT; e++) {
+        BenchLegacyEventData event = bench_legacy_create();
+        event.type = PT_INPUT_EVENT_MOUSEMOVE;
+        event.mouse.x = e;
+        bench_legacy_push(event);
+    }
+    while (bench_legacy_count > 0) {
+        bench_sink += bench_legacy_pull().type;
+    }
+    return bench_now_ns() - start;
+}
+
+static double bench_compact_round() {
+    double start = bench_now_ns();
+    for (int e = 0; e < PT_MAX_EVENT_COUNT; e++) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = PT_INPUT_EVENT_MOUSEMOVE;
+        event.mouse.x = e;
+        bench_compact_push(event);
+    }
+    while (bench_compact_count > 0) {
+        bench_sink += bench_compact_pull().type;
+    }
+    return bench_now_ns() - start;
+}
+
+static void bench_event_layout() {
+    double legacy = 0.0, compact = 0.0;
+
+    // warm both rings and the code, then alternate which layout goes first so neither always runs on a warmer cache
+    for (int round = 0; round < BENCH_ROUNDS / 10; round++) {
+        bench_legacy_round();
+        bench_compact_round();
+    }
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        if (round & 1) {
+            compact += bench_compact_round();
+            legacy += bench_legacy_round();
+        } else {
+            legacy += bench_legacy_round();
+            compact += bench_compact_round();
+        }
+    }
+
+    double events = (double)BENCH_ROUNDS * PT_MAX_EVENT_COUNT;
+    printf("event layout, push + pull\n");
+    printf("  legacy:  %6.2f ns/event, %3d bytes/event, %6d bytes/queue\n",
+        legacy / events, (int)sizeof(BenchLegacyEventData), (int)sizeof(BenchLegacyEventData) * PT_MAX_EVENT_COUNT);
+    printf("  compact: %6.2f ns/event, %3d bytes/event, %6d bytes/queue\n",
+        compact / events, (int)sizeof(PtInputEventData), (int)sizeof(PtInputEventData) * PT_MAX_EVENT_COUNT);
+}
+
+static void bench_coalesce_frame(PtWindow *window, const char *label) {
+    int samples = 1000; // a 1000 Hz mouse during a one second hitch
+    double total = 0.0;
+    int queued = 0, key_kept = 0;
+    pt_reset_event_counters(window);
+
+    for (int round = 0; round < BENCH_ROUNDS / 100; round++) {
+        double start = bench_now_ns();
+        for (int e = 0; e < samples; e++) {
+            PtInputEventData event = pt_create_input_event_data();
+            event.type = PT_INPUT_EVENT_MOUSEMOVE;
+            event.mouse.x = e;
+            event.mouse.dx = 1;
+            pt_push_input_event(window, event);
+        }
+
+        PtInputEventData key = pt_create_input_event_data();
+        key.type = PT_INPUT_EVENT_KEYUP;
+        pt_push_input_event(window, key);
+        total += bench_now_ns() - start;
+
+        queued = pt_get_input_event_count(window);
+        key_kept = 0;
+        while (pt_get_input_event_count(window) > 0) {
+            key_kept |= pt_pull_input_event(window).type == PT_INPUT_EVENT_KEYUP;
+        }
+    }
+
+    printf("  %-9s: %6.2f ns/push, %3d queued, %6d moves dropped, keyup %s\n", label,
+        total / ((double)(BENCH_ROUNDS / 100) * (samples + 1)), queued,
+        pt_get_dropped_event_count(window, PT_INPUT_EVENT_MOUSEMOVE), key_kept ? "kept" : "dropped");
+}
+
+static void bench_coalescing(PtWindow *window) {
+    printf("mouse flood, 1000 moves then a keyup\n");
+    window->input_event_overflow_policy = PT_EVENT_OVERFLOW_DROP_NEWEST;
+    bench_coalesce_frame(window, "drop new");
+
+    window->input_event_overflow_policy = PT_EVENT_OVERFLOW_EVICT_MOTION;
+    bench_coalesce_frame(window, "evict");
+
+    pt_enable_event_coalescing(window);
+    bench_coalesce_frame(window, "coalesced");
+    pt_disable_event_coalescing(window);
+}
+
+// "is W held" the old way, replaying the frame's events, against the state snapshot
+static void bench_input_state(PtWindow *window) {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    double replay = 0.0;
+    PT_BOOL held = PT_FALSE;
+    int key_w = 87;
+
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        PtInputEventData key = pt_create_input_event_data();
+        key.type = round & 1 ? PT_INPUT_EVENT_KEYUP : PT_INPUT_EVENT_KEYDOWN;
+        key.key.key = key_w;
+        pt_push_input_event(window, key);
+        bench_fill(window, PT_MAX_EVENT_COUNT - 1);
+
+        double start = bench_now_ns();
+        int count = pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+        for (int e = 0; e < count; e++) {
+            if (out[e].type == PT_INPUT_EVENT_KEYDOWN && out[e].key.key == key_w) held = PT_TRUE;
+            if (out[e].type == PT_INPUT_EVENT_KEYUP && out[e].key.key == key_w) held = PT_FALSE;
+        }
+        bench_sink += held;
+        replay += bench_now_ns() - start;
+    }
+
+    // one query is far below the clock resolution, time them in bulk
+    double start = bench_now_ns();
+    for (int round = 0; round < BENCH_ROUNDS; round++) {
+        bench_sink += pt_is_key_down(window, key_w + (round & 1));
+    }
+    double query = bench_now_ns() - start;
+
+    printf("key held, %d events per frame\n", PT_MAX_EVENT_COUNT);
+    printf("  replay:         %7.2f ns/frame\n", replay / BENCH_ROUNDS);
+    printf("  pt_is_key_down: %7.2f ns/frame\n", query / BENCH_ROUNDS);
+}
+
+#define BENCH_SPSC_EVENTS 2000000
+
+static void *bench_spsc_producer(void *arg) {
+    PtWindow *window = (PtWindow*)arg;
+    int capacity = pt_get_input_event_capacity(window);
+
+    for (int e = 0; e < BENCH_SPSC_EVENTS; e++) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = PT_INPUT_EVENT_KEYDOWN;
+        event.key.key = e;
+
+        // a full queue drops, wait for the consumer instead so every event is accounted for
+        while (pt_get_input_event_count(window) >= capacity) {
+            sched_yield();
+        }
+
+        pt_push_input_event(window, event);
+    }
+
+    return NULL;
+}
+
+// one thread pushes while this one drains, test.c checks order and loss
+static void bench_spsc(PtWindow *window) {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    pthread_t producer;
+    int pulled = 0;
+
+    double start = bench_now_ns();
+    pthread_create(&producer, NULL, bench_spsc_producer, window);
+
+    while (pulled < BENCH_SPSC_EVENTS) {
+        int count = pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+        if (count == 0) {
+            sched_yield();
+        }
+        pulled += count;
+    }
+
+    pthread_join(producer, NULL);
+    double total = bench_now_ns() - start;
+
+    printf("spsc, producer and consumer threads\n");
+    printf("  %d events, %6.2f ns/event, %6.1f M events/s\n",
+        BENCH_SPSC_EVENTS, total / BENCH_SPSC_EVENTS, BENCH_SPSC_EVENTS / total * 1000.0);
+}
+
+int main() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+
+    if (!pt_init(config)) {
+        return 1;
+    }
+
+    PtWindow *window = pt_create_window("bench queue", 0, 0, PT_FLAG_NONE);
+
+    bench_drain(window);
+    bench_push(window);
+    bench_batch_drain(window);
+    bench_event_layout();
+    bench_coalescing(window);
+    bench_input_state(window);
+
+    config->concurrent_event_queue = PT_TRUE;
+    PtWindow *spsc_window = pt_create_window("bench spsc", 0, 0, PT_FLAG_NONE);
+    bench_spsc(spsc_window);
+    pt_destroy_window(spsc_window);
+
+    pt_destroy_window(window);
+    pt_shutdown();
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return 0;
+}
@@ -0,0 +1,176 @@
+// Event waiting benchmarks: pt_wait_events wake latency and idle cost, and the pt_wait reactor.
+#include "bench.h"
+
+#define BENCH_WAIT_ROUNDS 100
+
+typedef struct BenchWaitRun {
+    PtWindow *window;
+    _Atomic int64_t posted_at;
+    atomic_int ready;
+    int64_t latency[BENCH_WAIT_ROUNDS];
+    int64_t cpu_ns;
+} BenchWaitRun;
+
+static int64_t bench_thread_cpu_ns() {
+    struct timespec ts;
+    clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+    return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
+}
+
+static void *bench_wait_thread(void *arg) {
+    BenchWaitRun *run = (BenchWaitRun*)arg;
+    int64_t cpu_start = bench_thread_cpu_ns();
+
+    for (int round = 0; round < BENCH_WAIT_ROUNDS; round++) {
+        atomic_store(&run->ready, round + 1);
+        pt_wait_events(run->window, -1.0);
+        run->latency[round] = pt_get_time_ns() - atomic_load(&run->posted_at);
+    }
+
+    run->cpu_ns = bench_thread_cpu_ns() - cpu_start;
+    return NULL;
+}
+
+static void bench_wait_events(PtWindow *window) {
+    BenchWaitRun run;
+    pthread_t thread;
+
+    run.window = window;
+    atomic_init(&run.posted_at, 0);
+    atomic_init(&run.ready, 0);
+
+    printf("pt_wait_events, woken by pt_post_empty_event every 2 ms\n");
+    int64_t start = pt_get_time_ns();
+    pthread_create(&thread, NULL, bench_wait_thread, &run);
+    for (int round = 0; round < BENCH_WAIT_ROUNDS; round++) {
+        while (atomic_load(&run.ready) != round + 1) {
+            sched_yield();
+        }
+
+        pt_sleep(0.002);
+        atomic_store(&run.posted_at, pt_get_time_ns());
+        pt_post_context_empty_event(pt_get_window_context(window));
+    }
+    pthread_join(thread, NULL);
+    int64_t wall = pt_get_time_ns() - start;
+
+    qsort(run.latency, BENCH_WAIT_ROUNDS, sizeof(int64_t), bench_compare_i64);
+    printf("  wake latency p50 %.1f us, p99 %.1f us\n", run.latency[BENCH_WAIT_ROUNDS / 2] / 1000.0, run.latency[BENCH_WAIT_ROUNDS * 99 / 100] / 1000.0);
+    printf("  waiting thread used %.2f%% of one cpu\n", 100.0 * run.cpu_ns / wall);
+}
+
+typedef struct BenchReactorRun {
+    int fd;
+    _Atomic int64_t written_at;
+    _Atomic int ready;
+} BenchReactorRun;
+
+static void *bench_reactor_thread(void *arg) {
+    BenchReactorRun *run = (BenchReactorRun*)arg;
+    char byte = 1;
+
+    for (int round = 0; round < BENCH_WAIT_ROUNDS; round++) {
+        while (atomic_load(&run->ready) != round + 1) {
+            sched_yield();
+        }
+
+        pt_sleep(0.002);
+        atomic_store(&run->written_at, pt_get_time_ns());
+        if (write(run->fd, &byte, 1) != 1) {
+            break;
+        }
+    }
+
+    return NULL;
+}
+
+static void bench_reactor() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+
+    PtContext *context = pt_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "bench reactor", 0, 0, PT_FLAG_NONE);
+    PtWaitResult result;
+    PtWakeReason reasons;
+    int pipe_fds[2];
+
+    printf("pt_wait reactor\n");
+    if (pipe(pipe_fds) != 0 || !pt_watch_fd(context, pipe_fds[0], PT_FD_READABLE)) {
+        printf("  reactor unavailable, skipped\n");
+        pt_destroy_window(window);
+        pt_destroy_context(context);
+        pt_destroy_backend(config->backend);
+        pt_destroy_config(config);
+        return;
+    }
+
+    // the window throttles in pt_wait, pt_swap_buffers only moves the deadline on
+    pt_enable_throttle(window, 250);
+    pt_set_throttle_in_wait(window, PT_TRUE);
+    int64_t late[BENCH_WAIT_ROUNDS];
+    for (int round = 0; round < BENCH_WAIT_ROUNDS; round++) {
+        pt_swap_buffers(window);
+        do {
+            reasons = pt_wait(window, -1.0, &result);
+        } while (!(reasons & PT_WAKE_DEADLINE));
+        late[round] = pt_get_time_ns() - window->frame_deadline;
+    }
+    pt_disable_throttle(window);
+    qsort(late, BENCH_WAIT_ROUNDS, sizeof(int64_t), bench_compare_i64);
+    printf("  deadline wake      p50 %8.1f us late, p99 %8.1f us\n", late[BENCH_WAIT_ROUNDS / 2] / 1000.0, late[BENCH_WAIT_ROUNDS * 99 / 100] / 1000.0);
+
+    BenchReactorRun run;
+    pthread_t thread;
+    int64_t latency[BENCH_WAIT_ROUNDS];
+    char byte;
+
+    run.fd = pipe_fds[1];
+    atomic_init(&run.written_at, 0);
+    atomic_init(&run.ready, 0);
+
+    pthread_create(&thread, NULL, bench_reactor_thread, &run);
+    for (int round = 0; round < BENCH_WAIT_ROUNDS; round++) {
+        atomic_store(&run.ready, round + 1);
+        do {
+            reasons = pt_wait(window, -1.0, &result);
+        } while (!(reasons & PT_WAKE_FD));
+        latency[round] = pt_get_time_ns() - atomic_load(&run.written_at);
+
+        if (read(pipe_fds[0], &byte, 1) != 1) {
+            break;
+        }
+    }
+    pthread_join(thread, NULL);
+    qsort(latency, BENCH_WAIT_ROUNDS, sizeof(int64_t), bench_compare_i64);
+    printf("  pipe write to wake p50 %8.1f us,      p99 %8.1f us\n", latency[BENCH_WAIT_ROUNDS / 2] / 1000.0, latency[BENCH_WAIT_ROUNDS * 99 / 100] / 1000.0);
+
+    pt_unwatch_fd(context, pipe_fds[0]);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+
+    pt_destroy_window(window);
+    pt_destroy_context(context);
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+}
+
+int main() {
+    PtConfig *config = pt_create_config();
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+
+    if (!pt_init(config)) {
+        return 1;
+    }
+
+    PtWindow *window = pt_create_window("bench wait", 0, 0, PT_FLAG_NONE);
+
+    bench_wait_events(window);
+    bench_reactor();
+
+    pt_destroy_window(window);
+    pt_shutdown();
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+
+    return 0;
+}
@@ -1,8 +1,15 @@
+// clock_gettime, clock_nanosleep and the epoll family are POSIX and Linux, not C11
+#ifndef _WIN32
+#define _DEFAULT_SOURCE
+#endif
+
 #include "portal.h"
 #include "portal_noop.h"
 #include <stdio.h>
 #include <stdlib.h>
 #include <stdint.h>
+#include <string.h>
+#include <stdatomic.h>
 
 #ifdef _WIN32
 #include <windows.h>
@@ -10,6 +17,21 @@
 #else
 #include <time.h>
 #include <unistd.h>
+#include <errno.h>
+#endif
+
+#ifdef __linux__
+#include <sys/epoll.h>
+#include <sys/eventfd.h>
+#include <sys/timerfd.h>
+#endif
+
+#if defined(__x86_64__) || defined(__i386__)
+    #define PT_CPU_RELAX() __builtin_ia32_pause()
+#elif defined(__aarch64__)
+    #define PT_CPU_RELAX() __asm__ __volatile__("yield")
+#else
+    #define PT_CPU_RELAX()
 #endif
 
 #ifdef PT_GLFW
@@ -20,181 +42,1443 @@
 #include "portal_android.h"
 #endif
 
-static PtConfig *active_config = NULL;
+#define PT_WINDOW_POOL_SIZE 4
+
+// One portal instance, nothing in here is shared between contexts.
+struct PtContext {
+    PtConfig *config;
+    PtBackend *backend;
+    int event_queue_capacity; // validated copy, later edits to the config do not reach new windows
+    void *window_pool[PT_WINDOW_POOL_SIZE];
+    size_t window_pool_block_size;
+    int window_pool_count;
+    #ifdef __linux__
+    int epoll_fd; // reactor of pt_wait, -1 when it could not be set up
+    int timer_fd;
+    int wake_fd;
+    int display_fd; // the backend's event fd once pt_wait has added it
+    #endif
+};
+
+// used by the wrappers that take no context, pt_init, pt_shutdown and pt_create_window
+static PtContext *default_context = NULL;
+
+// spin margin of pt_sleep_until_ns, -1 until pt_calibrate_sleep has run
+static _Atomic int64_t sleep_margin_ns = -1;
+
+// PT_DIRECT_DISPATCH resolves backend calls at compile time when exactly one
+// backend is built in, so hot per-frame calls skip the function pointer table
+// and can be inlined by LTO or a unity build.
+#ifdef PT_DIRECT_DISPATCH
+    #if defined(PT_GLFW) && defined(PT_ANDROID)
+        #error "PT_DIRECT_DISPATCH requires exactly one backend"
+    #elif defined(PT_GLFW)
+        #define PT_DIRECT_BACKEND_TYPE PT_BACKEND_GLFW
+        #define PT_BACKEND(window, name) pt_glfw_##name
+        #define PT_BACKEND_USABLE_WIDTH(window) pt_glfw_get_framebuffer_width(window)
+        #define PT_BACKEND_USABLE_HEIGHT(window) pt_glfw_get_framebuffer_height(window)
+        #define PT_BACKEND_USABLE_XOFFSET(window) pt_glfw_offset_zero(window)
+        #define PT_BACKEND_USABLE_YOFFSET(window) pt_glfw_offset_zero(window)
+    #elif defined(PT_ANDROID)
+        #define PT_DIRECT_BACKEND_TYPE PT_BACKEND_ANDROID
+        #define PT_BACKEND(window, name) pt_android_##name
+        #define PT_BACKEND_USABLE_WIDTH(window) pt_android_get_usable_framebuffer_width(window)
+        #define PT_BACKEND_USABLE_HEIGHT(window) pt_android_get_usable_framebuffer_height(window)
+        #define PT_BACKEND_USABLE_XOFFSET(window) pt_android_get_usable_framebuffer_xoffset(window)
+        #define PT_BACKEND_USABLE_YOFFSET(window) pt_android_get_usable_framebuffer_yoffset(window)
+    #else
+        #define PT_DIRECT_BACKEND_TYPE PT_BACKEND_NOOP
+        #define PT_BACKEND(window, name) pt_noop_##name
+        #define PT_BACKEND_USABLE_WIDTH(window) pt_noop_get_framebuffer_width(window)
+        #define PT_BACKEND_USABLE_HEIGHT(window) pt_noop_get_framebuffer_height(window)
+        #define PT_BACKEND_USABLE_XOFFSET(window) pt_noop_offset_zero(window)
+        #define PT_BACKEND_USABLE_YOFFSET(window) pt_noop_offset_zero(window)
+    #endif
+
+    #define PT_BACKEND_HAS(window, name) 1
+    #define PT_ASSERT_BACKEND(window)
+#else
+    #define PT_BACKEND(window, name) (window)->context->backend->name
+    #define PT_BACKEND_USABLE_WIDTH(window) (window)->context->backend->get_usable_width(window)
+    #define PT_BACKEND_USABLE_HEIGHT(window) (window)->context->backend->get_usable_height(window)
+    #define PT_BACKEND_USABLE_XOFFSET(window) (window)->context->backend->get_usable_xoffset(window)
+    #define PT_BACKEND_USABLE_YOFFSET(window) (window)->context->backend->get_usable_yoffset(window)
+
+    #define PT_BACKEND_HAS(window, name) ((window)->context->backend->name != NULL)
+    #define PT_ASSERT_BACKEND(window) \
+        PT_ASSERT_DEBUG((window) != NULL); \
+        PT_ASSERT_DEBUG((window)->context != NULL)
+#endif
+
+static void *pt_default_alloc(size_t size, void *user_data) {
+    return PT_MALLOC(size);
+}
+
+static void pt_default_free(void *ptr, size_t size, void *user_data) {
+    PT_FREE(ptr);
+}
+
+PtConfig *pt_create_config() {
+    PtConfig *config = PT_ALLOC(PtConfig);
+    config->backend = NULL;
+    config->allocator.alloc = pt_default_alloc;
+    config->allocator.free = pt_default_free;
+    config->allocator.user_data = NULL;
+    config->event_queue_capacity = PT_MAX_EVENT_COUNT;
+    config->event_overflow_policy = PT_EVENT_OVERFLOW_EVICT_MOTION;
+    config->frame_overrun_policy = PT_FRAME_OVERRUN_SKIP;
+    config->background_policy = PT_BACKGROUND_KEEP_RUNNING;
+    config->background_states = PT_BACKGROUND_MINIMIZED | PT_BACKGROUND_HIDDEN | PT_BACKGROUND_APP_HIDDEN;
+    config->background_fps = 10;
+    config->concurrent_event_queue = PT_FALSE;
+
+    return config;
+}
+
+void pt_destroy_config(PtConfig *config) {
+    PT_ASSERT(config != NULL);
+    PT_ASSERT(default_context == NULL || default_context->config != config);
+
+    PT_FREE(config);
+}
+
+void pt_assert_failed(const char *cond, const char *file, int line) {
+    printf("Assertion failed: %s, file: %s, line: %d\n", cond, file, line);
+    exit(1);
+}
+
+void *pt_alloc(PtContext *context, size_t size) {
+    PT_ASSERT(context != NULL);
+
+    return context->config->allocator.alloc(size, context->config->allocator.user_data);
+}
+
+void pt_free(PtContext *context, void *ptr, size_t size) {
+    PT_ASSERT(context != NULL);
+
+    if (ptr) {
+        context->config->allocator.free(ptr, size, context->config->allocator.user_data);
+    }
+}
+
+// Destroyed window blocks are kept for the next pt_alloc_window of the same size
+// and handed back to the allocator when the context is destroyed.
+#define PT_WINDOW_HANDLE_OFFSET ((sizeof(PtWindow) + 15) & ~(size_t)15)
+
+PtWindow *pt_alloc_window(PtContext *context, size_t handle_size) {
+    PT_ASSERT(context != NULL);
+
+    size_t block_size = PT_WINDOW_HANDLE_OFFSET + handle_size;
+    char *block;
+
+    if (context->window_pool_count > 0 && context->window_pool_block_size == block_size) {
+        block = context->window_pool[--context->window_pool_count];
+    } else {
+        block = pt_alloc(context, block_size);
+        if (block == NULL) {
+            return NULL;
+        }
+    }
+
+    PT_MEMSET(block, 0, block_size);
+
+    PtWindow *window = (PtWindow*)block;
+    window->handle = handle_size > 0 ? block + PT_WINDOW_HANDLE_OFFSET : NULL;
+    window->block_size = block_size;
+    window->context = context;
+
+    return window;
+}
+
+void pt_free_window(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    PtContext *context = window->context;
+    if (context->window_pool_count == 0) {
+        context->window_pool_block_size = window->block_size;
+    }
+
+    if (context->window_pool_count < PT_WINDOW_POOL_SIZE && context->window_pool_block_size == window->block_size) {
+        context->window_pool[context->window_pool_count++] = window;
+    } else {
+        pt_free(context, window, window->block_size);
+    }
+}
+
+static void pt_drain_window_pool(PtContext *context) {
+    while (context->window_pool_count > 0) {
+        pt_free(context, context->window_pool[--context->window_pool_count], context->window_pool_block_size);
+    }
+}
+
+PtBackendType pt_get_optimal_backend_type() {
+    #if PT_ANDROID
+        return PT_BACKEND_ANDROID;
+    #endif
+
+    #if PT_GLFW
+        return PT_BACKEND_GLFW;
+    #endif
+
+    return PT_BACKEND_NOOP;
+}
+
+void pt_destroy_backend(PtBackend *backend) {
+    PT_ASSERT(backend != NULL);
+    PT_FREE(backend);
+}
+
+PtBackend *pt_create_backend(PtBackendType type) {
+    #ifdef PT_DIRECT_DISPATCH
+        // every call goes straight to the compiled backend, any other one would get its handles
+        if (type != PT_DIRECT_BACKEND_TYPE) {
+            printf("Backend type %d is not the one compiled for PT_DIRECT_DISPATCH\n", type);
+            return NULL;
+        }
+    #endif
+
+    switch (type) {
+        #ifdef PT_GLFW
+        case PT_BACKEND_GLFW:
+            return pt_glfw_create();
+        #endif
+
+        #ifdef PT_ANDROID
+        case PT_BACKEND_ANDROID:
+            return pt_android_create();
+        #endif
+
+        case PT_BACKEND_NOOP:
+            return pt_noop_create();
+
+        default:
+            printf("Unknown backend type: %d\n", type);
+    }
+
+    return NULL;
+}
+
+#define PT_CACHE_LINE_SIZE 64
+
+// Free-running head/tail ring, the slot is the index masked by capacity - 1.
+// head is only written by the consumer and tail only by the producer, padded onto separate cache lines,
+// which makes the queue safe for one producer thread and one consumer thread without locks.
+struct PtEventQueue {
+    PtInputEventData *events;
+    unsigned int mask;
+    PT_BOOL concurrent;
+    char head_pad[PT_CACHE_LINE_SIZE];
+    atomic_uint head;
+    char tail_pad[PT_CACHE_LINE_SIZE - sizeof(atomic_uint)];
+    atomic_uint tail;
+    _Atomic int pushed[PT_INPUT_EVENT_TYPE_COUNT]; // per type counters, written only by the producer next to tail
+    _Atomic int dropped[PT_INPUT_EVENT_TYPE_COUNT];
+    char end_pad[PT_CACHE_LINE_SIZE];
+};
+
+static PtEventQueue *pt_create_event_queue(PtContext *context, int capacity, PT_BOOL concurrent) {
+    PtEventQueue *queue = (PtEventQueue*)pt_alloc(context, sizeof(PtEventQueue));
+    if (queue == NULL) {
+        return NULL;
+    }
+
+    queue->events = (PtInputEventData*)pt_alloc(context, sizeof(PtInputEventData) * capacity);
+    if (queue->events == NULL) {
+        pt_free(context, queue, sizeof(PtEventQueue));
+        return NULL;
+    }
+    queue->mask = (unsigned int)capacity - 1;
+    queue->concurrent = concurrent;
+    atomic_init(&queue->head, 0);
+    atomic_init(&queue->tail, 0);
+
+    return queue;
+}
+
+static void pt_destroy_event_queue(PtContext *context, PtEventQueue *queue) {
+    pt_free(context, queue->events, sizeof(PtInputEventData) * (queue->mask + 1));
+    pt_free(context, queue, sizeof(PtEventQueue));
+}
+
+int pt_get_input_event_count(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+    return (int)(tail - head);
+}
+
+int pt_get_input_event_capacity(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return (int)window->input_queue->mask + 1;
+}
+
+_Static_assert(sizeof(PtInputEventData) <= 32, "PtInputEventData should fit in 32 bytes");
+
+PtInputEventData pt_create_input_event_data() {
+    PtInputEventData event;
+    PT_MEMSET(&event, 0, sizeof(PtInputEventData));
+
+    return event;
+}
+
+static int pt_latency_bucket(int64_t ns) {
+    if (ns < 8) {
+        return ns < 0 ? 0 : (int)ns;
+    }
+
+    #if defined(_MSC_VER)
+        unsigned long msb;
+        _BitScanReverse64(&msb, (unsigned long long)ns);
+    #else
+        int msb = 63 - __builtin_clzll((unsigned long long)ns);
+    #endif
+
+    int bucket = ((int)msb - 2) * 8 + (int)((ns >> (msb - 3)) & 7);
+    return bucket < PT_LATENCY_BUCKET_COUNT ? bucket : PT_LATENCY_BUCKET_COUNT - 1;
+}
+
+static int64_t pt_latency_bucket_value(int bucket) {
+    if (bucket < 8) {
+        return bucket;
+    }
+
+    // middle of the bucket's range
+    int msb = bucket / 8 + 2;
+    int64_t width = (int64_t)1 << (msb - 3);
+    return (8 + bucket % 8) * width + width / 2;
+}
+
+static void pt_record_latency(PtLatencyHistogram *histogram, int64_t ns) {
+    histogram->buckets[pt_latency_bucket(ns)]++;
+    histogram->count++;
+
+    if (ns > histogram->max) {
+        histogram->max = ns;
+    }
+}
+
+static void pt_record_pull_latency(PtWindow *window, const PtInputEventData *events, int count) {
+    int64_t now = pt_get_time_ns();
+
+    if (window->latency_first_pull == 0) {
+        window->latency_first_pull = now;
+    }
+
+    for (int e = 0; e < count; e++) {
+        if (events[e].timestamp != 0) {
+            pt_record_latency(&window->latency[PT_LATENCY_CAPTURE_TO_PULL], now - events[e].timestamp);
+        }
+    }
+}
+
+void pt_enable_latency_stats(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    window->latency_enabled = PT_TRUE;
+    window->latency_first_pull = 0;
+}
+
+void pt_disable_latency_stats(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    window->latency_enabled = PT_FALSE;
+}
+
+void pt_reset_latency_stats(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    window->latency_first_pull = 0;
+    PT_MEMSET(window->latency, 0, sizeof(window->latency));
+}
+
+void pt_get_latency_stats(PtWindow *window, PtLatencyKind kind, PtLatencyStats *stats) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(kind >= 0 && kind < PT_LATENCY_KIND_COUNT);
+    PT_ASSERT(stats != NULL);
+
+    const PtLatencyHistogram *histogram = &window->latency[kind];
+    double percentiles[3] = { 0.50, 0.95, 0.99 };
+    double *results[3] = { &stats->p50, &stats->p95, &stats->p99 };
+
+    stats->count = (int)histogram->count;
+    stats->max = histogram->max / 1000000000.0;
+
+    for (int p = 0; p < 3; p++) {
+        uint32_t rank = (uint32_t)(percentiles[p] * histogram->count + 0.5);
+        uint32_t seen = 0;
+        int bucket = 0;
+
+        for (; bucket < PT_LATENCY_BUCKET_COUNT - 1; bucket++) {
+            seen += histogram->buckets[bucket];
+            if (seen >= rank && seen > 0) {
+                break;
+            }
+        }
+
+        *results[p] = histogram->count > 0 ? pt_latency_bucket_value(bucket) / 1000000000.0 : 0.0;
+    }
+}
+
+static void pt_update_input_state(PtInputState *state, const PtInputEventData *event);
+
+// A concurrent queue's pushing thread leaves the input state alone, the consumer catches it up here.
+static inline void pt_update_pulled_input_state(PtWindow *window, const PtInputEventData *events, int count) {
+    if (window->input_queue->concurrent) {
+        for (int e = 0; e < count; e++) {
+            pt_update_input_state(&window->input_state, &events[e]);
+        }
+    }
+}
+
+PtInputEventData pt_pull_input_event(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (head != tail) {
+        PtInputEventData event = queue->events[head & queue->mask];
+
+        atomic_store_explicit(&queue->head, head + 1, memory_order_release);
+
+        pt_update_pulled_input_state(window, &event, 1);
+        if (window->latency_enabled) {
+            pt_record_pull_latency(window, &event, 1);
+        }
+
+        return event;
+    }
+
+    return pt_create_input_event_data();
+}
+
+int pt_pull_input_events(PtWindow *window, PtInputEventData *out, int max) {
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(out != NULL || max == 0);
+
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    int count = (int)(tail - head) < max ? (int)(tail - head) : max;
+    if (count <= 0) {
+        return 0;
+    }
+
+    // at most two copies, the run up to the end of the ring and the wrapped remainder
+    int slot = (int)(head & queue->mask);
+    int first = (int)queue->mask + 1 - slot;
+    if (first > count) {
+        first = count;
+    }
+
+    memcpy(out, &queue->events[slot], sizeof(PtInputEventData) * first);
+    memcpy(out + first, &queue->events[0], sizeof(PtInputEventData) * (count - first));
+
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+
+    pt_update_pulled_input_state(window, out, count);
+    if (window->latency_enabled) {
+        pt_record_pull_latency(window, out, count);
+    }
+
+    return count;
+}
+
+int pt_peek_input_events(PtWindow *window, const PtInputEventData **events) {
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(events != NULL);
+
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    int slot = (int)(head & queue->mask);
+    int count = (int)queue->mask + 1 - slot;
+    if (count > (int)(tail - head)) {
+        count = (int)(tail - head);
+    }
+
+    *events = &queue->events[slot];
+    return count;
+}
+
+void pt_skip_input_events(PtWindow *window, int count) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_acquire);
+
+    if (count > (int)(tail - head)) {
+        count = (int)(tail - head);
+    }
+
+    if (count <= 0) {
+        return;
+    }
+
+    // peeked events are only consumed here, so this is where they count as pulled
+    int slot = (int)(head & queue->mask);
+    int first = (int)queue->mask + 1 - slot;
+    if (first > count) {
+        first = count;
+    }
+
+    pt_update_pulled_input_state(window, &queue->events[slot], first);
+    pt_update_pulled_input_state(window, &queue->events[0], count - first);
+    if (window->latency_enabled) {
+        pt_record_pull_latency(window, &queue->events[slot], first);
+        pt_record_pull_latency(window, &queue->events[0], count - first);
+    }
+
+    atomic_store_explicit(&queue->head, head + count, memory_order_release);
+}
+
+static PT_BOOL pt_is_motion_event(PtInputEventType type) {
+    return type == PT_INPUT_EVENT_MOUSEMOVE || type == PT_INPUT_EVENT_MOUSEWHEEL || type == PT_INPUT_EVENT_TOUCHMOVE;
+}
+
+static PT_BOOL pt_coalesce_input_event(PtWindow *window, PtInputEventData *event) {
+    PtEventQueue *queue = window->input_queue;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    // only look through the motion events at the back of the queue, merging past a button or key would reorder them
+    for (unsigned int i = tail; i != head; i--) {
+        PtInputEventData *pending = &queue->events[(i - 1) & queue->mask];
+        if (!pt_is_motion_event(pending->type)) {
+            return PT_FALSE;
+        }
+
+        if (pending->type != event->type) {
+            continue;
+        }
+
+        switch (event->type) {
+            case PT_INPUT_EVENT_MOUSEMOVE:
+            case PT_INPUT_EVENT_MOUSEWHEEL:
+                pending->mouse.x = event->mouse.x;
+                pending->mouse.y = event->mouse.y;
+                pending->mouse.dx += event->mouse.dx;
+                pending->mouse.dy += event->mouse.dy;
+                break;
+            case PT_INPUT_EVENT_TOUCHMOVE:
+                if (pending->touch.finger != event->touch.finger) {
+                    continue;
+                }
+
+                pending->touch.x = event->touch.x;
+                pending->touch.y = event->touch.y;
+                break;
+            default:
+                return PT_FALSE;
+        }
+
+        pending->timestamp = event->timestamp;
+        window->coalesced_event_count++;
+        return PT_TRUE;
+    }
+
+    return PT_FALSE;
+}
+
+void pt_enable_event_coalescing(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT_WARN(!window->input_queue->concurrent, "event coalescing is ignored on a concurrent event queue");
+
+    window->coalesce_enabled = PT_TRUE;
+}
+
+void pt_disable_event_coalescing(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    window->coalesce_enabled = PT_FALSE;
+}
+
+int pt_get_coalesced_event_count(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return window->coalesced_event_count;
+}
+
+int pt_get_input_event_type_index(PtInputEventType type) {
+    switch (type) {
+        case PT_INPUT_EVENT_KEYUP: return 1;
+        case PT_INPUT_EVENT_KEYDOWN: return 2;
+        case PT_INPUT_EVENT_KEYPRESS: return 3;
+        case PT_INPUT_EVENT_TEXT: return 4;
+        case PT_INPUT_EVENT_MOUSEUP: return 5;
+        case PT_INPUT_EVENT_MOUSEDOWN: return 6;
+        case PT_INPUT_EVENT_MOUSEMOVE: return 7;
+        case PT_INPUT_EVENT_MOUSEWHEEL: return 8;
+        case PT_INPUT_EVENT_TOUCHUP: return 9;
+        case PT_INPUT_EVENT_TOUCHDOWN: return 10;
+        case PT_INPUT_EVENT_TOUCHMOVE: return 11;
+        default: return 0;
+    }
+}
+
+void pt_set_event_mask(PtWindow *window, PtEventMask mask) {
+    PT_ASSERT_BACKEND(window);
+
+    window->event_mask = mask;
+
+    if (PT_BACKEND_HAS(window, set_event_mask)) {
+        PT_BACKEND(window, set_event_mask)(window, mask);
+    }
+}
+
+PtEventMask pt_get_event_mask(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return window->event_mask;
+}
+
+PT_BOOL pt_is_event_enabled(PtWindow *window, PtInputEventType type) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return (window->event_mask & (1 << pt_get_input_event_type_index(type))) != 0;
+}
+
+// Only the pushing thread writes the counters, so a relaxed load and store is enough and avoids a locked add.
+static inline void pt_increment_counter(_Atomic int *counter) {
+    atomic_store_explicit(counter, atomic_load_explicit(counter, memory_order_relaxed) + 1, memory_order_relaxed);
+}
+
+int pt_get_pushed_event_count(PtWindow *window, PtInputEventType type) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return atomic_load_explicit(&window->input_queue->pushed[pt_get_input_event_type_index(type)], memory_order_relaxed);
+}
+
+int pt_get_dropped_event_count(PtWindow *window, PtInputEventType type) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return atomic_load_explicit(&window->input_queue->dropped[pt_get_input_event_type_index(type)], memory_order_relaxed);
+}
+
+void pt_reset_event_counters(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    window->coalesced_event_count = 0;
+    for (int i = 0; i < PT_INPUT_EVENT_TYPE_COUNT; i++) {
+        atomic_store_explicit(&window->input_queue->pushed[i], 0, memory_order_relaxed);
+        atomic_store_explicit(&window->input_queue->dropped[i], 0, memory_order_relaxed);
+    }
+}
+
+static PT_BOOL pt_evict_motion_event(PtWindow *window) {
+    PtEventQueue *queue = window->input_queue;
+    PtInputEventData *events = queue->events;
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_relaxed);
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+
+    for (unsigned int i = head; i != tail; i++) {
+        if (!pt_is_motion_event(events[i & queue->mask].type)) {
+            continue;
+        }
+
+        pt_increment_counter(&queue->dropped[pt_get_input_event_type_index(events[i & queue->mask].type)]);
+
+        // close the gap by moving the older events up one slot, the oldest motion event is usually near the head
+        for (unsigned int j = i; j != head; j--) {
+            events[j & queue->mask] = events[(j - 1) & queue->mask];
+        }
+
+        atomic_store_explicit(&queue->head, head + 1, memory_order_relaxed);
+        return PT_TRUE;
+    }
+
+    return PT_FALSE;
+}
+
+static void pt_update_input_state(PtInputState *state, const PtInputEventData *event) {
+    switch (event->type) {
+        case PT_INPUT_EVENT_KEYDOWN:
+        case PT_INPUT_EVENT_KEYPRESS:
+            if (event->key.key >= 0 && event->key.key < PT_MAX_KEY_COUNT) {
+                state->keys[event->key.key >> 5] |= 1u << (event->key.key & 31);
+            }
+            break;
+        case PT_INPUT_EVENT_KEYUP:
+            if (event->key.key >= 0 && event->key.key < PT_MAX_KEY_COUNT) {
+                state->keys[event->key.key >> 5] &= ~(1u << (event->key.key & 31));
+            }
+            break;
+        case PT_INPUT_EVENT_MOUSEDOWN:
+            if (event->mouse.button >= 0 && event->mouse.button < 32) {
+                state->buttons |= 1u << event->mouse.button;
+            }
+            break;
+        case PT_INPUT_EVENT_MOUSEUP:
+            if (event->mouse.button >= 0 && event->mouse.button < 32) {
+                state->buttons &= ~(1u << event->mouse.button);
+            }
+            break;
+        case PT_INPUT_EVENT_MOUSEMOVE:
+            state->cursor_x = event->mouse.x;
+            state->cursor_y = event->mouse.y;
+            break;
+        case PT_INPUT_EVENT_TOUCHDOWN:
+        case PT_INPUT_EVENT_TOUCHMOVE:
+            if (event->touch.finger >= 0 && event->touch.finger < PT_MAX_TOUCH_COUNT) {
+                state->touches |= 1u << event->touch.finger;
+                state->touch_x[event->touch.finger] = event->touch.x;
+                state->touch_y[event->touch.finger] = event->touch.y;
+            }
+            break;
+        case PT_INPUT_EVENT_TOUCHUP:
+            if (event->touch.finger >= 0 && event->touch.finger < PT_MAX_TOUCH_COUNT) {
+                state->touches &= ~(1u << event->touch.finger);
+            }
+            break;
+        default:
+            break;
+    }
+}
+
+PT_BOOL pt_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(window->context != NULL);
+
+    PtBackend *backend = window->context->backend;
+    if (!pt_backend_supports(backend, PT_CAPABILITY_RELATIVE_MOUSE) || !backend->set_relative_mouse_mode) {
+        return PT_FALSE;
+    }
+
+    if (!backend->set_relative_mouse_mode(window, enabled)) {
+        return PT_FALSE;
+    }
+
+    window->relative_mouse = enabled;
+    return PT_TRUE;
+}
+
+PT_BOOL pt_is_relative_mouse_mode(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return window->relative_mouse;
+}
+
+PT_BOOL pt_is_key_down(PtWindow *window, int key) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    if (key < 0 || key >= PT_MAX_KEY_COUNT) {
+        return PT_FALSE;
+    }
+
+    return (window->input_state.keys[key >> 5] >> (key & 31)) & 1;
+}
+
+PT_BOOL pt_is_mouse_button_down(PtWindow *window, int button) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    if (button < 0 || button >= 32) {
+        return PT_FALSE;
+    }
+
+    return (window->input_state.buttons >> button) & 1;
+}
+
+uint32_t pt_get_mouse_state(PtWindow *window, float *x, float *y) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    pt_get_cursor_pos(window, x, y);
+    return window->input_state.buttons;
+}
+
+void pt_get_cursor_pos(PtWindow *window, float *x, float *y) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    if (x) *x = window->input_state.cursor_x;
+    if (y) *y = window->input_state.cursor_y;
+}
+
+PT_BOOL pt_get_touch(PtWindow *window, int finger, int *x, int *y) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    if (finger < 0 || finger >= PT_MAX_TOUCH_COUNT || !((window->input_state.touches >> finger) & 1)) {
+        return PT_FALSE;
+    }
+
+    if (x) *x = window->input_state.touch_x[finger];
+    if (y) *y = window->input_state.touch_y[finger];
+    return PT_TRUE;
+}
+
+const PtInputState *pt_get_input_state(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return &window->input_state;
+}
+
+PT_BOOL pt_start_input_recording(PtWindow *window, const char *path) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(path != NULL);
+
+    pt_stop_input_recording(window);
+
+    FILE *file = fopen(path, "wb");
+    if (file == NULL) {
+        return PT_FALSE;
+    }
+
+    PtInputRecordingHeader header;
+    header.magic = PT_INPUT_RECORDING_MAGIC;
+    header.version = PT_INPUT_RECORDING_VERSION;
+    header.event_size = sizeof(PtInputEventData);
+    header.reserved = 0;
+
+    if (fwrite(&header, sizeof(PtInputRecordingHeader), 1, file) != 1) {
+        fclose(file);
+        return PT_FALSE;
+    }
+
+    window->input_recording = file;
+    return PT_TRUE;
+}
+
+void pt_stop_input_recording(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    if (window->input_recording != NULL) {
+        fclose((FILE*)window->input_recording);
+        window->input_recording = NULL;
+    }
+}
+
+void pt_push_input_event(PtWindow *window, PtInputEventData event) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    PtEventQueue *queue = window->input_queue;
+    int type_index = pt_get_input_event_type_index(event.type);
+
+    // backends already skip masked out events before building them, this covers events pushed by the app
+    if (!(window->event_mask & (1 << type_index))) {
+        return;
+    }
+
+    pt_increment_counter(&queue->pushed[type_index]);
+
+    // a concurrent queue's state is owned by the consumer and updated on pull
+    if (!queue->concurrent) {
+        pt_update_input_state(&window->input_state, &event);
+    }
+
+    // every sample is recorded before coalescing so a replay sees the original stream
+    if (window->input_recording != NULL && fwrite(&event, sizeof(PtInputEventData), 1, (FILE*)window->input_recording) != 1) {
+        // later records would be misaligned after a short write, keep what is whole and stop
+        PT_ASSERT_WARN(PT_FALSE, "input recording write failed, recording stopped");
+        pt_stop_input_recording(window);
+    }
+
+    // coalescing and eviction rewrite slots the consumer owns, so a concurrent queue only ever appends
+    if (!queue->concurrent && window->coalesce_enabled && pt_is_motion_event(event.type) && pt_coalesce_input_event(window, &event)) {
+        return;
+    }
+
+    unsigned int tail = atomic_load_explicit(&queue->tail, memory_order_relaxed);
+    unsigned int head = atomic_load_explicit(&queue->head, memory_order_acquire);
+
+    if (tail - head > queue->mask) {
+        // motion is the cheapest thing to lose, so it never evicts anything itself
+        PT_BOOL evicted = !queue->concurrent &&
+            window->input_event_overflow_policy == PT_EVENT_OVERFLOW_EVICT_MOTION &&
+            !pt_is_motion_event(event.type) &&
+            pt_evict_motion_event(window);
+
+        if (!evicted) {
+            pt_increment_counter(&queue->dropped[type_index]);
+            return;
+        }
+    }
+
+    queue->events[tail & queue->mask] = event;
+    atomic_store_explicit(&queue->tail, tail + 1, memory_order_release);
+}
+
+PtWindow* pt_create_context_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags) {
+    PT_ASSERT(context != NULL);
+
+    PtWindow *window = context->backend->create_window(context, title, width, height, flags);
+    if (window == NULL) {
+        return NULL;
+    }
+
+    PT_ASSERT(window->context == context);
+    window->input_queue = pt_create_event_queue(context, context->event_queue_capacity, context->config->concurrent_event_queue);
+    if (window->input_queue == NULL) {
+        PT_BACKEND(window, destroy_window)(window);
+        return NULL;
+    }
+    window->input_event_overflow_policy = context->config->event_overflow_policy;
+    window->frame_overrun_policy = context->config->frame_overrun_policy;
+    window->background_states = context->config->background_states;
+    window->background_policy = context->config->background_policy;
+    window->background_frame_duration_ns = context->config->background_fps > 0 ? 1000000000LL / context->config->background_fps : 0;
+    window->in_background = PT_FALSE;
+    window->throttle_in_wait = PT_FALSE;
+    window->late_poll = PT_FALSE;
+    window->late_poll_end = 0;
+    window->late_poll_slept = PT_FALSE;
+    window->render_cost = 0;
+    window->coalesce_enabled = PT_FALSE;
+    window->event_mask = PT_EVENT_MASK_ALL;
+    PT_MEMSET(&window->input_state, 0, sizeof(PtInputState));
+    window->latency_enabled = PT_FALSE;
+    pt_reset_latency_stats(window);
+    pt_reset_frame_stats(window);
+    window->input_recording = NULL;
+    window->relative_mouse = PT_FALSE;
+    pt_reset_event_counters(window);
+
+    return window;
+}
+
+PtWindow* pt_create_window(const char *title, int width, int height, PtWindowFlags flags) {
+    PT_ASSERT(default_context != NULL);
+
+    return pt_create_context_window(default_context, title, width, height, flags);
+}
+
+void pt_destroy_window(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(window->context != NULL);
+
+    pt_stop_input_recording(window);
+    pt_destroy_event_queue(window->context, window->input_queue);
+    PT_BACKEND(window, destroy_window)(window);
+}
+
+// Headroom on top of the render cost estimate, absorbs small spikes the average has not seen yet.
+#define PT_LATE_POLL_HEADROOM_NS 250000
+
+void pt_poll_events(PtWindow *window) {
+    PT_ASSERT_BACKEND(window);
+
+    if (window->late_poll && window->late_poll_end == 0) {
+        // only the first poll of a frame waits, the render cost is timed from it
+        if (window->throttle_enabled && !window->in_background && window->render_cost > 0) {
+            int64_t budget = window->render_cost + window->render_cost / 4 + PT_LATE_POLL_HEADROOM_NS;
+            pt_sleep_until_ns(window->frame_deadline - budget);
+            window->late_poll_slept = PT_TRUE;
+        }
 
-#ifdef _WIN32
-static PT_BOOL high_precision_timer_init = PT_FALSE;
-#endif
+        PT_BACKEND(window, poll_events)(window);
+        window->late_poll_end = pt_get_time_ns();
+        return;
+    }
 
-PtConfig *pt_create_config() {
-    PtConfig *config = PT_ALLOC(PtConfig);
-    config->backend = NULL;
+    PT_BACKEND(window, poll_events)(window);
+}
 
-    return config;
+static uint32_t pt_saturate_u32(int64_t value) {
+    return value > (int64_t)UINT32_MAX ? UINT32_MAX : (uint32_t)value;
 }
 
-void pt_destroy_config(PtConfig *config) {
-    PT_ASSERT(config != NULL);
-    PT_ASSERT(active_config == NULL || active_config != config);
+static inline void pt_record_frame_timing(PtFrameTimings *timings, int64_t swap_start, int64_t swap_end) {
+    if (timings->last_swap_end != 0) {
+        uint32_t slot = timings->count++ & (PT_FRAME_TIMING_COUNT - 1);
+        timings->intervals[slot] = pt_saturate_u32(swap_end - timings->last_swap_end);
+        timings->swap_durations[slot] = pt_saturate_u32(swap_end - swap_start);
+    }
 
-    PT_FREE(config);
+    timings->last_swap_end = swap_end;
 }
 
-PtBackendType pt_get_optimal_backend_type() {
-    #if PT_ANDROID
-        return PT_BACKEND_ANDROID;
-    #endif
+static int pt_compare_u32(const void *a, const void *b) {
+    uint32_t x = *(const uint32_t*)a;
+    uint32_t y = *(const uint32_t*)b;
+    return (x > y) - (x < y);
+}
 
-    #if PT_GLFW
-        return PT_BACKEND_GLFW;
-    #endif
+// sorts values in place, fills mean, p50, p99 and max in seconds
+static void pt_summarize_frame_timings(uint32_t *values, int count, double *mean, double *p50, double *p99, double *max) {
+    if (count == 0) {
+        *mean = *p50 = *p99 = *max = 0.0;
+        return;
+    }
 
-    return PT_BACKEND_NOOP;
+    uint64_t sum = 0;
+    for (int i = 0; i < count; i++) {
+        sum += values[i];
+    }
+
+    qsort(values, count, sizeof(uint32_t), pt_compare_u32);
+
+    *mean = (double)sum / count / 1000000000.0;
+    *p50 = values[(int)(0.50 * (count - 1) + 0.5)] / 1000000000.0;
+    *p99 = values[(int)(0.99 * (count - 1) + 0.5)] / 1000000000.0;
+    *max = values[count - 1] / 1000000000.0;
 }
 
-void pt_destroy_backend(PtBackend *backend) {
-    PT_ASSERT(backend != NULL);
-    PT_FREE(backend);
+void pt_reset_frame_stats(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    PT_MEMSET(&window->frame_timings, 0, sizeof(PtFrameTimings));
 }
 
-PtBackend *pt_create_backend(PtBackendType type) {
-    switch (type) {
-        #ifdef PT_GLFW
-        case PT_BACKEND_GLFW:
-            return pt_glfw_create();
-        #endif
+void pt_get_frame_stats(PtWindow *window, PtFrameStats *stats) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(stats != NULL);
 
-        #ifdef PT_ANDROID
-        case PT_BACKEND_ANDROID:
-            return pt_android_create();
-        #endif
+    const PtFrameTimings *timings = &window->frame_timings;
+    uint32_t values[PT_FRAME_TIMING_COUNT];
+    int count = timings->count < PT_FRAME_TIMING_COUNT ? (int)timings->count : PT_FRAME_TIMING_COUNT;
+    int64_t missed_threshold = window->frame_duration_ns + window->frame_duration_ns / 2;
 
-        case PT_BACKEND_NOOP:
-            return pt_noop_create();
+    stats->count = count;
+    stats->missed_count = 0;
 
-        default:
-            printf("Unknown backend type: %d\n", type);
+    memcpy(values, timings->intervals, sizeof(uint32_t) * count);
+    for (int i = 0; i < count; i++) {
+        if (values[i] > missed_threshold) {
+            stats->missed_count++;
+        }
     }
+    pt_summarize_frame_timings(values, count, &stats->mean, &stats->p50, &stats->p99, &stats->max);
 
-    return NULL;
+    memcpy(values, timings->swap_durations, sizeof(uint32_t) * count);
+    pt_summarize_frame_timings(values, count, &stats->swap_mean, &stats->swap_p50, &stats->swap_p99, &stats->swap_max);
 }
 
-int pt_get_input_event_count(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+// Deadline of the frame after the one due at deadline, now is when that frame was presented.
+static int64_t pt_next_frame_deadline(int64_t deadline, int64_t duration, int64_t now, PtFrameOverrunPolicy policy) {
+    int64_t next = deadline + duration;
 
-    return active_config->backend->input_event_count;
+    if (policy == PT_FRAME_OVERRUN_SKIP && now >= next) {
+        next += ((now - next) / duration + 1) * duration;
+    }
+
+    return next;
 }
 
-PtInputEventData pt_create_input_event_data() {
-    PtInputEventData event;
+void pt_set_background_state(PtWindow *window, PtBackgroundState state, PT_BOOL active) {
+    PT_ASSERT_DEBUG(window != NULL);
 
-    event.type = PT_INPUT_EVENT_NONE;
-    event.mouse.button = 0;
-    event.mouse.x = 0;
-    event.mouse.y = 0;
-    event.mouse.dx = 0;
-    event.mouse.dy = 0;
-    event.mouse.modifiers = 0;
-    event.key.key = 0;
-    event.key.modifiers = 0;
-    event.touch.finger = 0;
-    event.touch.x = 0;
-    event.touch.y = 0;
-    event.text.codepoint = 0;
-    event.timestamp = 0.0;
+    if (active) {
+        window->background_state |= state;
+    } else {
+        window->background_state &= ~state;
+    }
+}
 
-    return event;
+PtBackgroundState pt_get_background_state(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return window->background_state;
 }
 
-PtInputEventData pt_pull_input_event(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+// Keeps the window's events flowing, at least every background frame, until it is back or should close.
+// States the system clears on its own, the app is stuck in here and could not clear the others.
+static PtBackgroundState pt_get_blocking_background_state(PtWindow *window) {
+    return window->background_state & window->background_states & ~PT_BACKGROUND_APP_HIDDEN;
+}
+
+static void pt_wait_while_background(PtWindow *window) {
+    while (pt_get_blocking_background_state(window) && !PT_BACKEND(window, should_window_close)(window)) {
+        pt_wait_events(window, window->background_frame_duration_ns / 1000000000.0);
+    }
+}
+
+// Reads the reactor's pending empty events, if any.
+static PT_BOOL pt_consume_wake_fd(PtContext *context) {
+    #ifdef __linux__
+        uint64_t value;
+        return context->wake_fd >= 0 && read(context->wake_fd, &value, sizeof(value)) > 0;
+    #else
+        return PT_FALSE;
+    #endif
+}
 
-    if (active_config->backend->input_event_count > 0) {
-        PtInputEventData event = active_config->backend->input_events[0];
+void pt_wait_events(PtWindow *window, double timeout) {
+    PT_ASSERT_BACKEND(window);
 
-        for (int i = 1; i < active_config->backend->input_event_count; i++) {
-            active_config->backend->input_events[i - 1] = active_config->backend->input_events[i];
+    if (PT_BACKEND_HAS(window, wait_events)) {
+        PT_BACKEND(window, wait_events)(window, timeout);
+    } else {
+        if (timeout > 0.0) {
+            pt_sleep(timeout);
         }
-
-        active_config->backend->input_event_count--;
-        return event;
+        PT_BACKEND(window, poll_events)(window);
     }
 
-    return pt_create_input_event_data();
+    pt_consume_wake_fd(window->context);
 }
 
-void pt_push_input_event(PtWindow *window, PtInputEventData event) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+void pt_post_context_empty_event(PtContext *context) {
+    PT_ASSERT(context != NULL);
 
-    if (active_config->backend->input_event_count >= PT_MAX_EVENT_COUNT) {
-        return;
+    // both waits are woken, each consumes the other's wake so neither returns again for nothing.
+    // the backend goes first, when pt_wait sees the eventfd the backend wake it clears is already there
+    if (context->backend->post_empty_event) {
+        context->backend->post_empty_event(context->backend);
     }
 
-    active_config->backend->input_events[active_config->backend->input_event_count++] = event;
+    #ifdef __linux__
+        if (context->wake_fd >= 0) {
+            uint64_t one = 1;
+            ssize_t written = write(context->wake_fd, &one, sizeof(one));
+            (void)written;
+        }
+    #endif
 }
 
-PtWindow* pt_create_window(const char *title, int width, int height, PtWindowFlags flags) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+void pt_post_empty_event() {
+    PT_ASSERT(default_context != NULL);
 
-    PtWindow *window = active_config->backend->create_window(title, width, height, flags);
-    return window;
+    pt_post_context_empty_event(default_context);
 }
 
-void pt_destroy_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+// Without a display fd the reactor cannot see window events, so waits are cut into slices this long.
+#define PT_WAIT_POLL_INTERVAL 0.004
 
-    active_config->backend->destroy_window(window);
+void pt_set_throttle_in_wait(PtWindow *window, PT_BOOL enabled) {
+    PT_ASSERT(window != NULL);
+
+    window->throttle_in_wait = enabled;
 }
 
-void pt_poll_events(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+PT_BOOL pt_watch_fd(PtContext *context, int fd, PtFdEvents events) {
+    PT_ASSERT(context != NULL);
+    PT_ASSERT(fd >= 0);
+
+    #ifdef __linux__
+        if (context->epoll_fd < 0) {
+            return PT_FALSE;
+        }
+
+        struct epoll_event event = { .events = 0, .data.fd = fd };
+        if (events & PT_FD_READABLE) event.events |= EPOLLIN;
+        if (events & PT_FD_WRITABLE) event.events |= EPOLLOUT;
+
+        if (epoll_ctl(context->epoll_fd, EPOLL_CTL_ADD, fd, &event) == 0) {
+            return PT_TRUE;
+        }
+
+        return errno == EEXIST && epoll_ctl(context->epoll_fd, EPOLL_CTL_MOD, fd, &event) == 0;
+    #else
+        return PT_FALSE;
+    #endif
+}
+
+void pt_unwatch_fd(PtContext *context, int fd) {
+    PT_ASSERT(context != NULL);
+
+    #ifdef __linux__
+        if (context->epoll_fd >= 0) {
+            epoll_ctl(context->epoll_fd, EPOLL_CTL_DEL, fd, NULL);
+        }
+    #endif
+}
+
+// Polls the backend and reports whether that queued anything.
+static PT_BOOL pt_poll_window_events(PtWindow *window) {
+    int count = pt_get_input_event_count(window);
+    PT_BACKEND(window, poll_events)(window);
+    return pt_get_input_event_count(window) != count;
+}
+
+PtWakeReason pt_wait(PtWindow *window, double timeout, PtWaitResult *result) {
+    PT_ASSERT_BACKEND(window);
+
+    PtWaitResult local;
+    if (result == NULL) {
+        result = &local;
+    }
+
+    result->reasons = 0;
+    result->fd_count = 0;
+
+    // events the last swap or poll left in the backend do not make the display fd readable again
+    if (pt_poll_window_events(window)) {
+        result->reasons |= PT_WAKE_WINDOW;
+        timeout = 0.0;
+    }
+
+    PT_BOOL deadline_armed = window->throttle_enabled && window->throttle_in_wait;
+    if (deadline_armed && pt_get_time_ns() >= window->frame_deadline) {
+        result->reasons |= PT_WAKE_DEADLINE;
+        deadline_armed = PT_FALSE;
+        timeout = 0.0;
+    }
+
+    #ifdef __linux__
+        PtContext *context = window->context;
+
+        if (context->epoll_fd >= 0) {
+            int display_fd = PT_BACKEND_HAS(window, get_event_fd) ? PT_BACKEND(window, get_event_fd)(window) : -1;
+            if (display_fd >= 0 && display_fd != context->display_fd) {
+                struct epoll_event display_event = { .events = EPOLLIN, .data.fd = display_fd };
+                if (epoll_ctl(context->epoll_fd, EPOLL_CTL_ADD, display_fd, &display_event) == 0 || errno == EEXIST) {
+                    context->display_fd = display_fd;
+                }
+            }
+
+            struct itimerspec timer = { { 0, 0 }, { 0, 0 } };
+            if (deadline_armed) {
+                timer.it_value.tv_sec = (time_t)(window->frame_deadline / 1000000000LL);
+                timer.it_value.tv_nsec = (long)(window->frame_deadline % 1000000000LL);
+            }
+            timerfd_settime(context->timer_fd, TFD_TIMER_ABSTIME, &timer, NULL);
+
+            int64_t end = timeout < 0.0 ? -1 : pt_get_time_ns() + (int64_t)(timeout * 1000000000.0);
+
+            do {
+                int64_t remaining = end < 0 ? -1 : end - pt_get_time_ns();
+                if (end >= 0 && remaining < 0) {
+                    remaining = 0;
+                }
+                if (display_fd < 0 && (remaining < 0 || remaining > (int64_t)(PT_WAIT_POLL_INTERVAL * 1000000000.0))) {
+                    remaining = (int64_t)(PT_WAIT_POLL_INTERVAL * 1000000000.0);
+                }
+                int timeout_ms = remaining < 0 ? -1 : (int)((remaining + 999999) / 1000000);
+
+                struct epoll_event events[PT_MAX_WAIT_FDS + 3];
+                int count = epoll_wait(context->epoll_fd, events, PT_TABLE_SIZE(events), timeout_ms);
+
+                for (int i = 0; i < count; i++) {
+                    int fd = events[i].data.fd;
+                    uint64_t value;
+
+                    if (fd == context->timer_fd) {
+                        if (read(fd, &value, sizeof(value)) > 0) {
+                            result->reasons |= PT_WAKE_DEADLINE;
+                        }
+                    } else if (fd == context->wake_fd) {
+                        if (pt_consume_wake_fd(context)) {
+                            result->reasons |= PT_WAKE_EMPTY_EVENT;
+
+                            // clears the backend's copy of the wake, which would end the next pt_wait_events at once
+                            if (PT_BACKEND_HAS(window, wait_events)) {
+                                PT_BACKEND(window, wait_events)(window, 0.0);
+                            }
+                        }
+                    } else if (fd == context->display_fd) {
+                        PT_BACKEND(window, poll_events)(window);
+                        result->reasons |= PT_WAKE_WINDOW;
+                    } else if (result->fd_count < PT_MAX_WAIT_FDS) {
+                        PtFdEvents ready = 0;
+                        if (events[i].events & EPOLLIN) ready |= PT_FD_READABLE;
+                        if (events[i].events & EPOLLOUT) ready |= PT_FD_WRITABLE;
+                        if (events[i].events & (EPOLLERR | EPOLLHUP)) ready |= PT_FD_ERROR;
+
+                        result->fds[result->fd_count] = fd;
+                        result->fd_events[result->fd_count] = ready;
+                        result->fd_count++;
+                        result->reasons |= PT_WAKE_FD;
+                    }
+                }
+
+                if (display_fd < 0 && pt_poll_window_events(window)) {
+                    result->reasons |= PT_WAKE_WINDOW;
+                }
+            } while (result->reasons == 0 && (end < 0 || pt_get_time_ns() < end));
+
+            return result->reasons;
+        }
+    #endif
+
+    if (result->reasons == 0) {
+        if (deadline_armed) {
+            double until_deadline = (window->frame_deadline - pt_get_time_ns()) / 1000000000.0;
+            if (timeout < 0.0 || until_deadline < timeout) {
+                timeout = until_deadline;
+            }
+        }
+
+        int count = pt_get_input_event_count(window);
+        pt_wait_events(window, timeout);
+        if (pt_get_input_event_count(window) != count) {
+            result->reasons |= PT_WAKE_WINDOW;
+        }
+
+        if (deadline_armed && pt_get_time_ns() >= window->frame_deadline) {
+            result->reasons |= PT_WAKE_DEADLINE;
+        }
+    }
 
-    active_config->backend->poll_events(window);
+    return result->reasons;
 }
 
 void pt_swap_buffers(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
+
+    int64_t swap_start = pt_get_time_ns();
+    PT_BACKEND(window, swap_buffers)(window);
+    int64_t swap_end = pt_get_time_ns();
+
+    pt_record_frame_timing(&window->frame_timings, swap_start, swap_end);
+
+    PT_BOOL late_poll_slept = window->late_poll_slept;
+    window->late_poll_slept = PT_FALSE;
+    if (window->late_poll_end != 0) {
+        int64_t cost = swap_end - window->late_poll_end;
+        // an overrun misses a frame, so grow quickly and shrink slowly
+        window->render_cost += (cost - window->render_cost) / (cost > window->render_cost ? 2 : 8);
+        window->late_poll_end = 0;
+    }
+
+    if (window->latency_enabled && window->latency_first_pull != 0) {
+        pt_record_latency(&window->latency[PT_LATENCY_PULL_TO_PRESENT], swap_end - window->latency_first_pull);
+        window->latency_first_pull = 0;
+    }
 
-    active_config->backend->swap_buffers(window);
+    int64_t duration = window->throttle_enabled ? window->frame_duration_ns : 0;
 
-    if (window->throttle_enabled) {
-        double current_time = pt_get_time();
-        double elapsed = current_time - window->last_frame_time;
-        double sleep_time = window->frame_duration - elapsed;
+    PT_BOOL background = window->background_policy != PT_BACKGROUND_KEEP_RUNNING && (window->background_state & window->background_states) != 0;
+    if (PT_UNLIKELY(background != window->in_background)) {
+        // restart the frame grid, neither side should try to catch up on the other's frames
+        window->in_background = background;
+        window->frame_deadline = swap_end;
+    }
 
-        if (sleep_time > 0.0) {
-            pt_sleep(sleep_time);
+    if (PT_UNLIKELY(background)) {
+        if (window->background_policy == PT_BACKGROUND_BLOCK && pt_get_blocking_background_state(window)) {
+            pt_wait_while_background(window);
+            window->in_background = PT_FALSE;
+            window->frame_deadline = pt_get_time_ns();
+        } else if (window->background_frame_duration_ns > duration) {
+            duration = window->background_frame_duration_ns;
         }
+    }
 
-        window->last_frame_time = pt_get_time();
+    if (duration > 0) {
+        // a late poll that waited already spent this frame's slack, anything else sleeps here as usual
+        if (!window->throttle_in_wait && !(late_poll_slept && !background)) {
+            pt_sleep_until_ns(window->frame_deadline);
+        }
+        window->frame_deadline = pt_next_frame_deadline(window->frame_deadline, duration, pt_get_time_ns(), window->frame_overrun_policy);
     }
 }
 
 PT_BOOL pt_use_gl_context(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->use_gl_context(window);
+    return PT_BACKEND(window, use_gl_context)(window);
 }
 
-PT_BOOL pt_init(PtConfig *config) {
+#ifdef __linux__
+static void pt_destroy_reactor(PtContext *context) {
+    int *fds[] = { &context->epoll_fd, &context->timer_fd, &context->wake_fd };
+
+    for (int i = 0; i < PT_TABLE_SIZE(fds); i++) {
+        if (*fds[i] >= 0) {
+            close(*fds[i]);
+        }
+        *fds[i] = -1;
+    }
+}
+
+// The timer and wake descriptors live in the epoll set for the whole context, the display fd joins on the first pt_wait.
+static void pt_create_reactor(PtContext *context) {
+    context->epoll_fd = epoll_create1(EPOLL_CLOEXEC);
+    context->timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+    context->wake_fd = eventfd(0, EFD_NONBLOCK | EFD_CLOEXEC);
+    context->display_fd = -1;
+
+    struct epoll_event timer_event = { .events = EPOLLIN, .data.fd = context->timer_fd };
+    struct epoll_event wake_event = { .events = EPOLLIN, .data.fd = context->wake_fd };
+
+    if (context->epoll_fd < 0 || context->timer_fd < 0 || context->wake_fd < 0 ||
+        epoll_ctl(context->epoll_fd, EPOLL_CTL_ADD, context->timer_fd, &timer_event) != 0 ||
+        epoll_ctl(context->epoll_fd, EPOLL_CTL_ADD, context->wake_fd, &wake_event) != 0) {
+        PT_ASSERT_WARN(PT_FALSE, "pt_wait reactor unavailable, falling back to polling");
+        pt_destroy_reactor(context);
+    }
+}
+#endif
+
+PtContext *pt_create_context(PtConfig *config) {
     PT_ASSERT(config != NULL);
     PT_ASSERT(config->backend != NULL);
-    PT_ASSERT(active_config == NULL);
+    PT_ASSERT(config->event_queue_capacity > 0);
+    PT_ASSERT((config->event_queue_capacity & (config->event_queue_capacity - 1)) == 0);
+    PT_ASSERT(config->allocator.alloc != NULL && config->allocator.free != NULL);
+    PT_ASSERT(config->background_policy == PT_BACKGROUND_KEEP_RUNNING || config->background_fps > 0);
+
+    #ifdef PT_DIRECT_DISPATCH
+        // also refused without assertions, a mismatched backend would corrupt memory rather than fail
+        PT_ASSERT(config->backend->type == PT_DIRECT_BACKEND_TYPE);
+        if (config->backend->type != PT_DIRECT_BACKEND_TYPE) {
+            return NULL;
+        }
+    #endif
+
+    PtContext *context = (PtContext*)config->allocator.alloc(sizeof(PtContext), config->allocator.user_data);
+    if (context == NULL) {
+        return NULL;
+    }
+
+    PT_MEMSET(context, 0, sizeof(PtContext));
+    context->config = config;
+    context->backend = config->backend;
+    context->event_queue_capacity = config->event_queue_capacity;
 
     if (!config->backend->init(config->backend, config)) {
-        return PT_FALSE;
+        pt_free(context, context, sizeof(PtContext));
+        return NULL;
     }
 
-    active_config = config;
-    return PT_TRUE;
+    #ifdef _WIN32
+        // reference counted by windows, matched in pt_destroy_context
+        timeBeginPeriod(1);
+    #else
+        if (atomic_load_explicit(&sleep_margin_ns, memory_order_relaxed) < 0) {
+            pt_calibrate_sleep();
+        }
+    #endif
+
+    #ifdef __linux__
+        pt_create_reactor(context);
+    #endif
+
+    return context;
+}
+
+void pt_destroy_context(PtContext *context) {
+    PT_ASSERT(context != NULL);
+
+    context->backend->shutdown(context->backend);
+    pt_drain_window_pool(context);
+
+    #ifdef _WIN32
+        timeEndPeriod(1);
+    #endif
+
+    #ifdef __linux__
+        pt_destroy_reactor(context);
+    #endif
+
+    pt_free(context, context, sizeof(PtContext));
+}
+
+PtContext *pt_get_default_context() {
+    return default_context;
+}
+
+PtContext *pt_get_window_context(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    return window->context;
+}
+
+PtBackend *pt_get_context_backend(PtContext *context) {
+    PT_ASSERT_DEBUG(context != NULL);
+
+    return context->backend;
+}
+
+PT_BOOL pt_init(PtConfig *config) {
+    PT_ASSERT(default_context == NULL);
+
+    default_context = pt_create_context(config);
+    return default_context != NULL;
 }
 
 PT_BOOL pt_backend_supports(PtBackend *backend, PtCapability capability) {
@@ -204,66 +1488,57 @@ PT_BOOL pt_backend_supports(PtBackend *backend, PtCapability capability) {
 }
 
 PT_BOOL pt_should_window_close(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->should_window_close(window);
+    return PT_BACKEND(window, should_window_close)(window);
 }
 
 int pt_get_window_width(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_window_width(window);
+    return PT_BACKEND(window, get_window_width)(window);
 }
 
 int pt_get_window_height(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_window_height(window);
+    return PT_BACKEND(window, get_window_height)(window);
 }
 
 int pt_get_framebuffer_width(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_framebuffer_width(window);
+    return PT_BACKEND(window, get_framebuffer_width)(window);
 }
 
 int pt_get_framebuffer_height(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_framebuffer_height(window);
+    return PT_BACKEND(window, get_framebuffer_height)(window);
 }
 
 int pt_get_usable_width(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_usable_width(window);
+    return PT_BACKEND_USABLE_WIDTH(window);
 }
 
 int pt_get_usable_height(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_usable_height(window);
+    return PT_BACKEND_USABLE_HEIGHT(window);
 }
 
 int pt_get_usable_xoffset(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_usable_xoffset(window);
+    return PT_BACKEND_USABLE_XOFFSET(window);
 }
 
 int pt_get_usable_yoffset(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_usable_yoffset(window);
+    return PT_BACKEND_USABLE_YOFFSET(window);
 }
 
 void pt_enable_throttle(PtWindow *window, int fps) {
@@ -272,8 +1547,8 @@ void pt_enable_throttle(PtWindow *window, int fps) {
 
     window->throttle_enabled = PT_TRUE;
     window->target_fps = fps;
-    window->frame_duration = 1.0 / fps;
-    window->last_frame_time = pt_get_time();
+    window->frame_duration_ns = 1000000000LL / fps;
+    window->frame_deadline = pt_get_time_ns() + window->frame_duration_ns;
 }
 
 void pt_disable_throttle(PtWindow *window) {
@@ -282,15 +1557,25 @@ void pt_disable_throttle(PtWindow *window) {
     window->throttle_enabled = PT_FALSE;
 }
 
+void pt_set_late_poll(PtWindow *window, PT_BOOL enabled) {
+    PT_ASSERT(window != NULL);
+
+    window->late_poll = enabled;
+    window->late_poll_end = 0;
+    window->late_poll_slept = PT_FALSE;
+    window->render_cost = 0; // the first frame polls immediately, measures and sleeps in pt_swap_buffers
+}
+
+double pt_get_render_cost(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    return window->render_cost / 1000000000.0;
+}
+
 void pt_sleep(double seconds) {
     if (seconds <= 0.0) return;
 
     #ifdef _WIN32
-        if (!high_precision_timer_init) {
-            timeBeginPeriod(1);
-            high_precision_timer_init = PT_TRUE;
-        }
-
         double sleep_threshold = 0.002;
 
         if (seconds > sleep_threshold) {
@@ -309,10 +1594,84 @@ void pt_sleep(double seconds) {
             }
         }
     #else
+        pt_sleep_until_ns(pt_get_time_ns() + (int64_t)(seconds * 1000000000.0));
+    #endif
+}
+
+#ifndef _WIN32
+// The OS sleep wakes up late by the timer slack, so pt_sleep_until_ns sleeps to the deadline
+// minus a margin and spins the rest. The margin is the measured overshoot, calibrated once per process.
+#define PT_SLEEP_CALIBRATION_ROUNDS 16
+#define PT_SLEEP_CALIBRATION_NS 200000
+#define PT_SLEEP_MIN_MARGIN_NS 20000
+#define PT_SLEEP_MAX_MARGIN_NS 2000000
+
+static void pt_os_sleep_until_ns(int64_t deadline_ns) {
+    #ifdef __linux__
         struct timespec ts;
-        ts.tv_sec = (time_t)seconds;
-        ts.tv_nsec = (long)((seconds - ts.tv_sec) * 1000000000.0);
-        nanosleep(&ts, NULL);
+        ts.tv_sec = (time_t)(deadline_ns / 1000000000LL);
+        ts.tv_nsec = (long)(deadline_ns % 1000000000LL);
+        while (clock_nanosleep(CLOCK_MONOTONIC, TIMER_ABSTIME, &ts, NULL) == EINTR) {
+        }
+    #else
+        int64_t remaining = deadline_ns - pt_get_time_ns();
+        if (remaining > 0) {
+            struct timespec ts;
+            ts.tv_sec = (time_t)(remaining / 1000000000LL);
+            ts.tv_nsec = (long)(remaining % 1000000000LL);
+            nanosleep(&ts, NULL);
+        }
+    #endif
+}
+#endif
+
+int64_t pt_calibrate_sleep() {
+    #ifdef _WIN32
+        return 0;
+    #else
+        int64_t overshoot[PT_SLEEP_CALIBRATION_ROUNDS];
+
+        for (int i = 0; i < PT_SLEEP_CALIBRATION_ROUNDS; i++) {
+            int64_t deadline = pt_get_time_ns() + PT_SLEEP_CALIBRATION_NS;
+            pt_os_sleep_until_ns(deadline);
+            int64_t late = pt_get_time_ns() - deadline;
+
+            // insertion sort, the array is tiny
+            int j = i;
+            while (j > 0 && overshoot[j - 1] > late) {
+                overshoot[j] = overshoot[j - 1];
+                j--;
+            }
+            overshoot[j] = late;
+        }
+
+        // second worst plus a quarter, a single outlier should not make every frame spin for it
+        int64_t margin = overshoot[PT_SLEEP_CALIBRATION_ROUNDS - 2];
+        margin += margin / 4;
+        if (margin < PT_SLEEP_MIN_MARGIN_NS) margin = PT_SLEEP_MIN_MARGIN_NS;
+        if (margin > PT_SLEEP_MAX_MARGIN_NS) margin = PT_SLEEP_MAX_MARGIN_NS;
+
+        atomic_store_explicit(&sleep_margin_ns, margin, memory_order_relaxed);
+        return margin;
+    #endif
+}
+
+void pt_sleep_until_ns(int64_t deadline_ns) {
+    #ifdef _WIN32
+        pt_sleep((double)(deadline_ns - pt_get_time_ns()) / 1000000000.0);
+    #else
+        int64_t margin = atomic_load_explicit(&sleep_margin_ns, memory_order_relaxed);
+        if (margin < 0) {
+            margin = pt_calibrate_sleep();
+        }
+
+        if (deadline_ns - pt_get_time_ns() > margin) {
+            pt_os_sleep_until_ns(deadline_ns - margin);
+        }
+
+        while (pt_get_time_ns() < deadline_ns) {
+            PT_CPU_RELAX();
+        }
     #endif
 }
 
@@ -336,163 +1695,149 @@ double pt_get_time() {
     #endif
 }
 
-void pt_shutdown() {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-
-    active_config->backend->shutdown(active_config->backend);
-
+int64_t pt_get_time_ns() {
     #ifdef _WIN32
-        if (high_precision_timer_init) {
-            timeEndPeriod(1);
-            high_precision_timer_init = PT_FALSE;
+        static LARGE_INTEGER frequency;
+        static PT_BOOL frequency_initialized = PT_FALSE;
+        LARGE_INTEGER counter;
+
+        if (!frequency_initialized) {
+            QueryPerformanceFrequency(&frequency);
+            frequency_initialized = PT_TRUE;
         }
+
+        // split into whole seconds and remainder so the multiplication cannot overflow
+        QueryPerformanceCounter(&counter);
+        int64_t seconds = counter.QuadPart / frequency.QuadPart;
+        int64_t remainder = counter.QuadPart % frequency.QuadPart;
+        return seconds * 1000000000LL + remainder * 1000000000LL / frequency.QuadPart;
+    #else
+        struct timespec ts;
+        clock_gettime(CLOCK_MONOTONIC, &ts);
+        return (int64_t)ts.tv_sec * 1000000000LL + ts.tv_nsec;
     #endif
+}
 
-    active_config = NULL;
+void pt_shutdown() {
+    PT_ASSERT(default_context != NULL);
+
+    pt_destroy_context(default_context);
+    default_context = NULL;
 }
 
 void* pt_get_window_handle(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    return active_config->backend->get_handle(window);
+    return PT_BACKEND(window, get_handle)(window);
 }
 
 void pt_set_window_title(PtWindow *window, const char *title) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
     PT_ASSERT(title != NULL);
 
-    if (active_config->backend->set_window_title) {
-        active_config->backend->set_window_title(window, title);
+    if (PT_BACKEND_HAS(window, set_window_title)) {
+        PT_BACKEND(window, set_window_title)(window, title);
     }
 }
 
 void pt_set_window_size(PtWindow *window, int width, int height) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
     PT_ASSERT(width > 0);
     PT_ASSERT(height > 0);
 
-    if (active_config->backend->set_window_size) {
-        active_config->backend->set_window_size(window, width, height);
+    if (PT_BACKEND_HAS(window, set_window_size)) {
+        PT_BACKEND(window, set_window_size)(window, width, height);
     }
 }
 
 void pt_set_video_mode(PtWindow *window, PtVideoMode mode) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->set_video_mode) {
-        active_config->backend->set_video_mode(window, mode);
+    if (PT_BACKEND_HAS(window, set_video_mode)) {
+        PT_BACKEND(window, set_video_mode)(window, mode);
     }
 }
 
 void pt_show_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->show_window) {
-        active_config->backend->show_window(window);
+    if (PT_BACKEND_HAS(window, show_window)) {
+        PT_BACKEND(window, show_window)(window);
     }
 }
 
 void pt_hide_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->hide_window) {
-        active_config->backend->hide_window(window);
+    if (PT_BACKEND_HAS(window, hide_window)) {
+        PT_BACKEND(window, hide_window)(window);
     }
 }
 
 void pt_minimize_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->minimize_window) {
-        active_config->backend->minimize_window(window);
+    if (PT_BACKEND_HAS(window, minimize_window)) {
+        PT_BACKEND(window, minimize_window)(window);
     }
 }
 
 void pt_maximize_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->maximize_window) {
-        active_config->backend->maximize_window(window);
+    if (PT_BACKEND_HAS(window, maximize_window)) {
+        PT_BACKEND(window, maximize_window)(window);
     }
 }
 
 void pt_restore_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->restore_window) {
-        active_config->backend->restore_window(window);
+    if (PT_BACKEND_HAS(window, restore_window)) {
+        PT_BACKEND(window, restore_window)(window);
     }
 }
 
 void pt_focus_window(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->focus_window) {
-        active_config->backend->focus_window(window);
+    if (PT_BACKEND_HAS(window, focus_window)) {
+        PT_BACKEND(window, focus_window)(window);
     }
 }
 
 PT_BOOL pt_is_window_maximized(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->is_window_maximized) {
-        return active_config->backend->is_window_maximized(window);
+    if (PT_BACKEND_HAS(window, is_window_maximized)) {
+        return PT_BACKEND(window, is_window_maximized)(window);
     }
     return PT_FALSE;
 }
 
 PT_BOOL pt_is_window_minimized(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->is_window_minimized) {
-        return active_config->backend->is_window_minimized(window);
+    if (PT_BACKEND_HAS(window, is_window_minimized)) {
+        return PT_BACKEND(window, is_window_minimized)(window);
     }
     return PT_FALSE;
 }
 
 PT_BOOL pt_is_window_focused(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->is_window_focused) {
-        return active_config->backend->is_window_focused(window);
+    if (PT_BACKEND_HAS(window, is_window_focused)) {
+        return PT_BACKEND(window, is_window_focused)(window);
     }
     return PT_FALSE;
 }
 
 PT_BOOL pt_is_window_visible(PtWindow *window) {
-    PT_ASSERT(active_config != NULL);
-    PT_ASSERT(active_config->backend != NULL);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_BACKEND(window);
 
-    if (active_config->backend->is_window_visible) {
-        return active_config->backend->is_window_visible(window);
+    if (PT_BACKEND_HAS(window, is_window_visible)) {
+        return PT_BACKEND(window, is_window_visible)(window);
     }
     return PT_FALSE;
 }
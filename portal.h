@@ -1,6 +1,9 @@
 #ifndef PORTAL_H
 #define PORTAL_H
 
+#include <stddef.h>
+#include <stdint.h>
+
 #ifdef __cplusplus
 extern "C"
 {
@@ -12,8 +15,43 @@ extern "C"
 
 #define PT_MALLOC(size) malloc(size)
 #define PT_ALLOC_MULTIPLE(obj, count) (obj*)malloc(sizeof(obj) * count)
-#define PT_ASSERT(cond) if(!(cond)) { printf("Assertion failed: %s, file: %s, line: %d\n", #cond, __FILE__, __LINE__); exit(1); }
-#define PT_ASSERT_WARN(cond, message) if(!(cond)) { printf("Warning: %s, file: %s, line: %d\n", message, __FILE__, __LINE__); }
+
+// PT_ASSERT_LEVEL 0 compiles every check out, 1 keeps PT_ASSERT for API misuse
+// at init and create time, 2 also keeps PT_ASSERT_DEBUG on per-frame and
+// per-event paths. Defaults to 1 with NDEBUG and 2 otherwise.
+#ifndef PT_ASSERT_LEVEL
+    #ifdef NDEBUG
+        #define PT_ASSERT_LEVEL 1
+    #else
+        #define PT_ASSERT_LEVEL 2
+    #endif
+#endif
+
+#if defined(__GNUC__) || defined(__clang__)
+    #define PT_UNLIKELY(cond) __builtin_expect(!!(cond), 0)
+    #define PT_COLD_NORETURN __attribute__((cold, noreturn))
+#else
+    #define PT_UNLIKELY(cond) (cond)
+    #define PT_COLD_NORETURN
+#endif
+
+#define PT_ASSERT_CHECK(cond) do { if (PT_UNLIKELY(!(cond))) { pt_assert_failed(#cond, __FILE__, __LINE__); } } while (0)
+#define PT_ASSERT_NONE(cond) ((void)sizeof(!(cond)))
+
+#if PT_ASSERT_LEVEL >= 1
+    #define PT_ASSERT(cond) PT_ASSERT_CHECK(cond)
+    #define PT_ASSERT_WARN(cond, message) do { if (PT_UNLIKELY(!(cond))) { printf("Warning: %s, file: %s, line: %d\n", message, __FILE__, __LINE__); } } while (0)
+#else
+    #define PT_ASSERT(cond) PT_ASSERT_NONE(cond)
+    #define PT_ASSERT_WARN(cond, message) PT_ASSERT_NONE(cond)
+#endif
+
+#if PT_ASSERT_LEVEL >= 2
+    #define PT_ASSERT_DEBUG(cond) PT_ASSERT_CHECK(cond)
+#else
+    #define PT_ASSERT_DEBUG(cond) PT_ASSERT_NONE(cond)
+#endif
+
 #define PT_MEMSET(ptr, value, size) memset(ptr, value, size)
 
 #define PT_ALLOC(obj) PT_ALLOC_MULTIPLE(obj, 1)
@@ -24,7 +62,15 @@ extern "C"
 #define PT_TRUE 1
 #define PT_FALSE 0
 
-#define PT_MAX_EVENT_COUNT 256
+#define PT_MAX_EVENT_COUNT 256 // default PtConfig.event_queue_capacity
+#define PT_MAX_KEY_COUNT 512 // key codes tracked by pt_is_key_down, covers GLFW_KEY_LAST
+#define PT_MAX_TOUCH_COUNT 16 // finger ids tracked by pt_get_touch
+#define PT_LATENCY_BUCKET_COUNT 256 // log-linear, 8 buckets per power of two nanoseconds, about 12% resolution
+#define PT_FRAME_TIMING_COUNT 256 // frames kept by pt_get_frame_stats, power of two
+#define PT_MAX_WAIT_FDS 16 // ready file descriptors reported by one pt_wait
+#define PT_INPUT_EVENT_TYPE_COUNT 12 // number of PtInputEventType values, see pt_get_input_event_type_index
+#define PT_INPUT_RECORDING_MAGIC 0x52495450 // "PTIR" little endian
+#define PT_INPUT_RECORDING_VERSION 1
 
 typedef enum {
     PT_BACKEND_NOOP = 1,
@@ -42,7 +88,8 @@ typedef enum {
     PT_CAPABILITY_CREATE_WINDOW = 1 << 0,
     PT_CAPABILITY_WINDOW_SIZE = 1 << 1,
     PT_CAPABILITY_WINDOW_POSITION = 1 << 2,
-    PT_CAPABILITY_WINDOW_VIDEO_MODE = 1 << 3
+    PT_CAPABILITY_WINDOW_VIDEO_MODE = 1 << 3,
+    PT_CAPABILITY_RELATIVE_MOUSE = 1 << 4
 } PtCapability;
 
 typedef enum {
@@ -58,8 +105,8 @@ typedef enum {
     // Mouse
     PT_INPUT_EVENT_MOUSEUP = 100,       // { button: PtMouseButton, modifiers: PtModifier }
     PT_INPUT_EVENT_MOUSEDOWN = 101,     // { button: PtMouseButton, modifiers: PtModifier }
-    PT_INPUT_EVENT_MOUSEMOVE = 102,     // { x: int, y: int, dx: int, dy: int }
-    PT_INPUT_EVENT_MOUSEWHEEL = 103,    // { x: int, y: int, dx: int, dy: int }
+    PT_INPUT_EVENT_MOUSEMOVE = 102,     // { x: float, y: float, dx: float, dy: float } position and movement since the previous one
+    PT_INPUT_EVENT_MOUSEWHEEL = 103,    // { x: float, y: float, dx: float, dy: float } cursor position and scroll offset
 
     // Touch
     PT_INPUT_EVENT_TOUCHUP = 200,       // { finger: int, x: int, y: int }
@@ -67,6 +114,75 @@ typedef enum {
     PT_INPUT_EVENT_TOUCHMOVE = 202,     // { finger: int, x: int, y: int }
 } PtInputEventType;
 
+// one bit per PtInputEventType, 1 << pt_get_input_event_type_index(type)
+typedef enum {
+    PT_EVENT_MASK_NONE = 0,
+    PT_EVENT_MASK_KEYUP = 1 << 1,
+    PT_EVENT_MASK_KEYDOWN = 1 << 2,
+    PT_EVENT_MASK_KEYPRESS = 1 << 3,
+    PT_EVENT_MASK_TEXT = 1 << 4,
+    PT_EVENT_MASK_MOUSEUP = 1 << 5,
+    PT_EVENT_MASK_MOUSEDOWN = 1 << 6,
+    PT_EVENT_MASK_MOUSEMOVE = 1 << 7,
+    PT_EVENT_MASK_MOUSEWHEEL = 1 << 8,
+    PT_EVENT_MASK_TOUCHUP = 1 << 9,
+    PT_EVENT_MASK_TOUCHDOWN = 1 << 10,
+    PT_EVENT_MASK_TOUCHMOVE = 1 << 11,
+
+    PT_EVENT_MASK_KEYBOARD = PT_EVENT_MASK_KEYUP | PT_EVENT_MASK_KEYDOWN | PT_EVENT_MASK_KEYPRESS | PT_EVENT_MASK_TEXT,
+    PT_EVENT_MASK_MOUSE = PT_EVENT_MASK_MOUSEUP | PT_EVENT_MASK_MOUSEDOWN | PT_EVENT_MASK_MOUSEMOVE | PT_EVENT_MASK_MOUSEWHEEL,
+    PT_EVENT_MASK_TOUCH = PT_EVENT_MASK_TOUCHUP | PT_EVENT_MASK_TOUCHDOWN | PT_EVENT_MASK_TOUCHMOVE,
+    PT_EVENT_MASK_ALL = PT_EVENT_MASK_KEYBOARD | PT_EVENT_MASK_MOUSE | PT_EVENT_MASK_TOUCH,
+} PtEventMask;
+
+typedef enum {
+    PT_EVENT_OVERFLOW_DROP_NEWEST = 0,   // a full queue discards whatever is pushed next
+    PT_EVENT_OVERFLOW_EVICT_MOTION = 1,  // a full queue makes room for key/button/touch events by evicting the oldest motion event
+} PtEventOverflowPolicy;
+
+typedef enum {
+    PT_FRAME_OVERRUN_SKIP = 0,      // a late frame moves the next deadline to the next free slot on the frame grid
+    PT_FRAME_OVERRUN_CATCH_UP = 1,  // deadlines keep advancing by one frame, late frames run back to back until caught up
+} PtFrameOverrunPolicy;
+
+typedef enum {
+    PT_BACKGROUND_KEEP_RUNNING = 0,  // background windows render like foreground ones
+    PT_BACKGROUND_THROTTLE = 1,      // pt_swap_buffers limits background windows to background_fps
+    PT_BACKGROUND_BLOCK = 2,         // pt_swap_buffers keeps polling events at background_fps and returns once the window is back, PT_BACKGROUND_APP_HIDDEN only throttles
+} PtBackgroundPolicy;
+
+typedef enum {
+    PT_BACKGROUND_MINIMIZED = 1 << 0,
+    PT_BACKGROUND_HIDDEN = 1 << 1,     // hidden by the system, like a paused Android activity
+    PT_BACKGROUND_UNFOCUSED = 1 << 2,
+    PT_BACKGROUND_APP_HIDDEN = 1 << 3, // pt_hide_window or PT_FLAG_HIDDEN, never blocks since only the app can show the window again
+} PtBackgroundState;
+
+typedef enum {
+    PT_FD_READABLE = 1 << 0,
+    PT_FD_WRITABLE = 1 << 1,
+    PT_FD_ERROR = 1 << 2, // error or hang up, reported even when not asked for
+} PtFdEvents;
+
+// Why pt_wait returned, 0 when the timeout passed.
+typedef enum {
+    PT_WAKE_WINDOW = 1 << 0,      // window events were polled
+    PT_WAKE_DEADLINE = 1 << 1,    // the window's next throttle deadline passed
+    PT_WAKE_FD = 1 << 2,          // watched file descriptors are ready, see PtWaitResult
+    PT_WAKE_EMPTY_EVENT = 1 << 3, // pt_post_empty_event
+} PtWakeReason;
+
+typedef enum {
+    PT_LATENCY_CAPTURE_TO_PULL = 0,  // event timestamp until the app pulls it, one sample per event
+    PT_LATENCY_PULL_TO_PRESENT = 1,  // first pull of a frame until pt_swap_buffers returns from the backend, one sample per frame
+    PT_LATENCY_KIND_COUNT = 2,
+} PtLatencyKind;
+
+typedef enum {
+    PT_REPLAY_ORIGINAL_TIMING = 0,  // events are pushed once as much time has passed as when they were recorded
+    PT_REPLAY_AS_FAST_AS_POSSIBLE = 1, // every poll pushes as many events as fit in the queue
+} PtReplayMode;
+
 typedef enum {
     PT_FLAG_NONE = 0,
     PT_FLAG_VSYNC = 1 << 0,
@@ -92,37 +208,50 @@ typedef enum {
 
 typedef struct PtConfig PtConfig;
 typedef struct PtBackend PtBackend;
+typedef struct PtContext PtContext;
 typedef struct PtWindow PtWindow;
 typedef struct PtInputEventKeyData PtInputEventKeyData;
 typedef struct PtInputEventMouseData PtInputEventMouseData;
 typedef struct PtInputEventTouchData PtInputEventTouchData;
 typedef struct PtInputEventTextData PtInputEventTextData;
 typedef struct PtInputEventData PtInputEventData;
+typedef struct PtEventQueue PtEventQueue;
+typedef struct PtInputState PtInputState;
+typedef struct PtLatencyHistogram PtLatencyHistogram;
+typedef struct PtLatencyStats PtLatencyStats;
+typedef struct PtInputRecordingHeader PtInputRecordingHeader;
+
+// Routes a context's allocations, size is passed back on free for tracking.
+typedef struct PtAllocator {
+    void *(*alloc)(size_t size, void *user_data);
+    void (*free)(void *ptr, size_t size, void *user_data);
+    void *user_data;
+} PtAllocator;
 
 typedef struct PtConfig {
     PtBackend *backend;
+    PtAllocator allocator; // defaults to malloc and free
+    int event_queue_capacity; // per window, must be a power of two, read once when the context is created
+    PtEventOverflowPolicy event_overflow_policy;
+    PT_BOOL concurrent_event_queue; // one thread may push while another pulls, disables coalescing and eviction
+    PtFrameOverrunPolicy frame_overrun_policy;
+    PtBackgroundPolicy background_policy;
+    PtBackgroundState background_states; // which states count as background, minimized and hidden by default
+    int background_fps;
 } PtConfig;
 
-typedef struct PtWindow {
-    void *handle;
-    PT_BOOL throttle_enabled;
-    int target_fps;
-    double last_frame_time;
-    double frame_duration;
-} PtWindow;
-
 typedef struct PtInputEventKeyData {
     int key;
     int modifiers;
 } PtInputEventKeyData;
 
 typedef struct PtInputEventMouseData {
-    int button;
-    int modifiers;
-    int x;
-    int y;
-    int dx;
-    int dy;
+    int16_t button;
+    int16_t modifiers;
+    float x;
+    float y;
+    float dx;
+    float dy;
 } PtInputEventMouseData;
 
 typedef struct PtInputEventTouchData {
@@ -135,21 +264,120 @@ typedef struct PtInputEventTextData {
     unsigned int codepoint;
 } PtInputEventTextData;
 
+// Only one payload is valid per event, see PtInputEventType for which one.
+// The payloads share storage so an event fits in 32 bytes.
 typedef struct PtInputEventData {
     PtInputEventType type;
-    PtInputEventKeyData key;
-    PtInputEventMouseData mouse;
-    PtInputEventTouchData touch;
-    PtInputEventTextData text;
-    double timestamp;
+    union {
+        PtInputEventKeyData key;
+        PtInputEventMouseData mouse;
+        PtInputEventTouchData touch;
+        PtInputEventTextData text;
+    };
+    int64_t timestamp; // capture time in nanoseconds on the pt_get_time_ns clock, 0 when unknown
 } PtInputEventData;
 
+// Input state as of the last pushed event, updated even when the queue overflows.
+// With concurrent_event_queue it is updated as events are pulled instead, so it belongs to the consuming thread and misses dropped events.
+// Only event types enabled in the window's event mask are seen.
+typedef struct PtInputState {
+    uint32_t keys[PT_MAX_KEY_COUNT / 32];
+    uint32_t buttons;
+    float cursor_x;
+    float cursor_y;
+    uint32_t touches; // one bit per active finger id
+    int touch_x[PT_MAX_TOUCH_COUNT];
+    int touch_y[PT_MAX_TOUCH_COUNT];
+} PtInputState;
+
+typedef struct PtLatencyHistogram {
+    uint32_t buckets[PT_LATENCY_BUCKET_COUNT];
+    uint32_t count;
+    int64_t max;
+} PtLatencyHistogram;
+
+// Ring of the last PT_FRAME_TIMING_COUNT frames, in nanoseconds saturated at about 4.3 seconds.
+typedef struct PtFrameTimings {
+    uint32_t intervals[PT_FRAME_TIMING_COUNT]; // from the end of one backend swap to the end of the next
+    uint32_t swap_durations[PT_FRAME_TIMING_COUNT]; // spent in the backend swap
+    uint32_t count; // frames recorded since the last reset, the slot is count & (PT_FRAME_TIMING_COUNT - 1)
+    int64_t last_swap_end; // 0 before the first swap
+} PtFrameTimings;
+
+typedef struct PtFrameStats {
+    int count; // frames in the ring
+    int missed_count; // intervals longer than one and a half frame_duration_ns
+    double mean; // seconds between frames
+    double p50;
+    double p99;
+    double max;
+    double swap_mean; // seconds in the backend swap
+    double swap_p50;
+    double swap_p99;
+    double swap_max;
+} PtFrameStats;
+
+typedef struct PtWaitResult {
+    PtWakeReason reasons;
+    int fd_count;
+    int fds[PT_MAX_WAIT_FDS];
+    PtFdEvents fd_events[PT_MAX_WAIT_FDS];
+} PtWaitResult;
+
+// all values in seconds, like pt_get_time
+typedef struct PtLatencyStats {
+    int count;
+    double p50;
+    double p95;
+    double p99;
+    double max;
+} PtLatencyStats;
+
+// An input recording is this header followed by raw PtInputEventData records, so it can be mapped and indexed directly.
+typedef struct PtInputRecordingHeader {
+    uint32_t magic;
+    uint32_t version;
+    uint32_t event_size; // sizeof(PtInputEventData) of the writer
+    uint32_t reserved;
+} PtInputRecordingHeader;
+
+typedef struct PtWindow {
+    void *handle; // backend data, placed in the same block as the window by pt_alloc_window
+    size_t block_size;
+    PtContext *context; // the context that created the window
+    PT_BOOL throttle_enabled;
+    int target_fps;
+    int64_t frame_deadline; // pt_get_time_ns time the current frame is due, advanced from itself so oversleep does not drift
+    int64_t frame_duration_ns;
+    PtFrameOverrunPolicy frame_overrun_policy;
+    PtBackgroundState background_state; // kept current by the backend's window callbacks
+    PtBackgroundState background_states;
+    PtBackgroundPolicy background_policy;
+    int64_t background_frame_duration_ns;
+    PT_BOOL in_background; // what the last pt_swap_buffers saw
+    PT_BOOL throttle_in_wait; // pt_swap_buffers only advances the deadline, pt_wait sleeps until it
+    PT_BOOL late_poll; // pt_poll_events sleeps until render_cost before the deadline, pt_swap_buffers does not sleep
+    int64_t late_poll_end; // when this frame's first pt_poll_events returned, 0 until then
+    PT_BOOL late_poll_slept; // this frame's poll waited for the deadline, so pt_swap_buffers does not
+    int64_t render_cost; // nanoseconds from poll to swap, moving average that rises fast and decays slowly
+    PtEventQueue *input_queue;
+    PtEventOverflowPolicy input_event_overflow_policy;
+    PtEventMask event_mask;
+    PtInputState input_state;
+    PT_BOOL latency_enabled;
+    int64_t latency_first_pull; // 0 until something is pulled after the last swap
+    PtLatencyHistogram latency[PT_LATENCY_KIND_COUNT];
+    PtFrameTimings frame_timings;
+    void *input_recording; // FILE*, NULL when not recording
+    PT_BOOL relative_mouse;
+    PT_BOOL coalesce_enabled;
+    int coalesced_event_count;
+} PtWindow;
+
 typedef struct PtBackend {
     PtBackendType type;
     PtBackendKind kind;
     PtCapability capabilities;
-    PtInputEventData input_events[PT_MAX_EVENT_COUNT];
-    int input_event_count;
 
     // core
     PT_BOOL (*init)(PtBackend *backend, PtConfig *config);
@@ -157,9 +385,12 @@ typedef struct PtBackend {
     void* (*get_handle)(PtWindow *window);
 
     // window
-    PtWindow *(*create_window)(const char *title, int width, int height, PtWindowFlags flags);
+    PtWindow *(*create_window)(PtContext *context, const char *title, int width, int height, PtWindowFlags flags);
     void (*destroy_window)(PtWindow *window);
     void (*poll_events)(PtWindow *window);
+    void (*wait_events)(PtWindow *window, double timeout);
+    void (*post_empty_event)(PtBackend *backend); // may be called from any thread
+    int (*get_event_fd)(PtWindow *window); // readable when window events are pending, -1 when there is none
     void (*swap_buffers)(PtWindow *window);
     void (*set_window_title)(PtWindow *window, const char *title);
     void (*set_window_size)(PtWindow *window, int width, int height);
@@ -184,6 +415,10 @@ typedef struct PtBackend {
     PT_BOOL (*is_window_focused)(PtWindow *window);
     PT_BOOL (*is_window_visible)(PtWindow *window);
 
+    // input
+    void (*set_event_mask)(PtWindow *window, PtEventMask mask);
+    PT_BOOL (*set_relative_mouse_mode)(PtWindow *window, PT_BOOL enabled);
+
     // lifecycle
     void (*activate)(PtWindow *window);
     void (*deactivate)(PtWindow *window);
@@ -193,10 +428,20 @@ typedef struct PtBackend {
     PT_BOOL (*use_gl_context)(PtWindow *window);
 } PtBackend;
 
-// Global
-PT_BOOL pt_init(PtConfig *config);
+// Global, wrappers over a default context
+PT_BOOL pt_init(PtConfig *config); // config must stay alive until pt_shutdown
 void pt_shutdown();
 
+// Context, an independent instance with its own config, backend and windows.
+// Per-window functions use the window's context, so contexts can run on separate threads.
+// GLFW and Android keep process wide state and only support one context, a second GLFW context fails to create.
+// The context keeps the config pointer, the config and its backend must outlive the context.
+PtContext *pt_create_context(PtConfig *config); // NULL when the backend fails to init
+void pt_destroy_context(PtContext *context); // destroy its windows first
+PtContext *pt_get_default_context(); // the one created by pt_init, NULL before
+PtContext *pt_get_window_context(PtWindow *window);
+PtBackend *pt_get_context_backend(PtContext *context);
+
 // Config
 PtConfig *pt_create_config();
 void pt_destroy_config(PtConfig *config);
@@ -205,11 +450,23 @@ void pt_destroy_config(PtConfig *config);
 PtBackend *pt_create_backend(PtBackendType type);
 void pt_destroy_backend(PtBackend *backend);
 PtBackendType pt_get_optimal_backend_type();
+PT_BOOL pt_backend_supports(PtBackend *backend, PtCapability capability);
 
 // Window
 PtWindow* pt_create_window(const char *title, int width, int height, PtWindowFlags flags);
+PtWindow* pt_create_context_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags);
 void pt_destroy_window(PtWindow *window);
 void pt_poll_events(PtWindow *window);
+void pt_wait_events(PtWindow *window, double timeout); // blocks until events arrive, an empty event is posted or timeout seconds pass, negative waits forever
+void pt_post_empty_event(); // wakes pt_wait_events on the default context from any thread
+void pt_post_context_empty_event(PtContext *context);
+
+// Reactor, one wait for window events, the throttle deadline and the application's file descriptors.
+// Uses epoll, timerfd and eventfd on Linux. Elsewhere pt_watch_fd fails and pt_wait only waits for window events.
+PT_BOOL pt_watch_fd(PtContext *context, int fd, PtFdEvents events);
+void pt_unwatch_fd(PtContext *context, int fd);
+PtWakeReason pt_wait(PtWindow *window, double timeout, PtWaitResult *result); // result may be NULL, negative timeout waits forever
+void pt_set_throttle_in_wait(PtWindow *window, PT_BOOL enabled);
 void pt_swap_buffers(PtWindow *window);
 void* pt_get_window_handle(PtWindow *window); // os-handle
 void pt_set_window_title(PtWindow *window, const char *title);
@@ -227,9 +484,49 @@ PT_BOOL pt_should_window_close(PtWindow *window);
 
 // events
 int pt_get_input_event_count(PtWindow *window);
+int pt_get_input_event_capacity(PtWindow *window);
 void pt_push_input_event(PtWindow *window, PtInputEventData event);
 PtInputEventData pt_pull_input_event(PtWindow *window);
+int pt_pull_input_events(PtWindow *window, PtInputEventData *out, int max); // returns the number of events copied
+int pt_peek_input_events(PtWindow *window, const PtInputEventData **events); // contiguous run at the front, no copy
+void pt_skip_input_events(PtWindow *window, int count); // releases events seen through pt_peek_input_events
 PtInputEventData pt_create_input_event_data();
+void pt_enable_event_coalescing(PtWindow *window); // merges queued MOUSEMOVE, MOUSEWHEEL and TOUCHMOVE events
+void pt_disable_event_coalescing(PtWindow *window);
+int pt_get_coalesced_event_count(PtWindow *window); // number of samples merged into an already queued event, always 0 on a concurrent queue
+int pt_get_input_event_type_index(PtInputEventType type); // dense index into the per-type counters
+int pt_get_pushed_event_count(PtWindow *window, PtInputEventType type); // every pt_push_input_event call, including merged and dropped ones
+int pt_get_dropped_event_count(PtWindow *window, PtInputEventType type); // discarded on overflow, either rejected or evicted
+void pt_reset_event_counters(PtWindow *window); // with a concurrent queue, increments racing the reset may survive it
+void pt_set_event_mask(PtWindow *window, PtEventMask mask); // masked out events are never generated by the backend
+PtEventMask pt_get_event_mask(PtWindow *window);
+PT_BOOL pt_is_event_enabled(PtWindow *window, PtInputEventType type);
+
+// relative mouse, hides and captures the cursor, MOUSEMOVE deltas are unbounded and unaccelerated where the OS allows it
+PT_BOOL pt_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled); // false if the backend lacks PT_CAPABILITY_RELATIVE_MOUSE
+PT_BOOL pt_is_relative_mouse_mode(PtWindow *window);
+
+// input state
+PT_BOOL pt_is_key_down(PtWindow *window, int key);
+PT_BOOL pt_is_mouse_button_down(PtWindow *window, int button);
+uint32_t pt_get_mouse_state(PtWindow *window, float *x, float *y); // returns the held buttons as a bitmask, x and y may be NULL
+void pt_get_cursor_pos(PtWindow *window, float *x, float *y);
+PT_BOOL pt_get_touch(PtWindow *window, int finger, int *x, int *y); // false if the finger is not down
+const PtInputState *pt_get_input_state(PtWindow *window);
+
+// recording, replay is done by the noop backend, see pt_noop_start_replay
+PT_BOOL pt_start_input_recording(PtWindow *window, const char *path);
+void pt_stop_input_recording(PtWindow *window);
+
+// latency
+void pt_enable_latency_stats(PtWindow *window);
+void pt_disable_latency_stats(PtWindow *window);
+void pt_reset_latency_stats(PtWindow *window);
+void pt_get_latency_stats(PtWindow *window, PtLatencyKind kind, PtLatencyStats *stats);
+
+// frame timing, always collected by pt_swap_buffers
+void pt_reset_frame_stats(PtWindow *window);
+void pt_get_frame_stats(PtWindow *window, PtFrameStats *stats); // missed frames are judged against frame_duration_ns, 60 fps unless throttled
 
 // context
 PT_BOOL pt_use_gl_context(PtWindow *window);
@@ -237,8 +534,22 @@ PT_BOOL pt_use_gl_context(PtWindow *window);
 // throttling
 void pt_enable_throttle(PtWindow *window, int fps);
 void pt_disable_throttle(PtWindow *window);
+void pt_set_late_poll(PtWindow *window, PT_BOOL enabled); // sample input just in time to render before the throttle deadline
+double pt_get_render_cost(PtWindow *window); // seconds, what late poll budgets for a frame
 void pt_sleep(double seconds);
+void pt_sleep_until_ns(int64_t deadline_ns); // deadline on the pt_get_time_ns clock, sleeps then spins the calibrated margin
+int64_t pt_calibrate_sleep(); // measures OS sleep overshoot and returns the new spin margin in nanoseconds, runs on first context creation
 double pt_get_time();
+int64_t pt_get_time_ns(); // same clock as pt_get_time, in integer nanoseconds
+
+// memory, through PtConfig.allocator
+void *pt_alloc(PtContext *context, size_t size);
+void pt_free(PtContext *context, void *ptr, size_t size);
+PtWindow *pt_alloc_window(PtContext *context, size_t handle_size); // zeroed window and backend handle in one pooled block
+void pt_free_window(PtWindow *window);
+
+// assertions
+PT_COLD_NORETURN void pt_assert_failed(const char *cond, const char *file, int line);
 
 // Window state management
 void pt_show_window(PtWindow *window);
@@ -248,6 +559,10 @@ void pt_maximize_window(PtWindow *window);
 void pt_restore_window(PtWindow *window);
 void pt_focus_window(PtWindow *window);
 
+// Called by backends when the window is minimized, hidden or loses focus and when it comes back
+void pt_set_background_state(PtWindow *window, PtBackgroundState state, PT_BOOL active);
+PtBackgroundState pt_get_background_state(PtWindow *window);
+
 // Window state queries
 PT_BOOL pt_is_window_maximized(PtWindow *window);
 PT_BOOL pt_is_window_minimized(PtWindow *window);
@@ -342,6 +342,20 @@ static void pt_android_handle_cmd(struct android_app* app, int32_t cmd) {
                 LOGI("Surface marked for destruction on next swap");
             }
             break;
+
+       case APP_CMD_PAUSE:
+       case APP_CMD_RESUME:
+            if (app->userData) {
+                pt_set_background_state((PtWindow*)app->userData, PT_BACKGROUND_HIDDEN, cmd == APP_CMD_PAUSE);
+            }
+            break;
+
+       case APP_CMD_LOST_FOCUS:
+       case APP_CMD_GAINED_FOCUS:
+            if (app->userData) {
+                pt_set_background_state((PtWindow*)app->userData, PT_BACKGROUND_UNFOCUSED, cmd == APP_CMD_LOST_FOCUS);
+            }
+            break;
     }
 }
 
@@ -398,16 +412,22 @@ void android_main(struct android_app* app) {
 int pt_android_handle_input(struct android_app* app, AInputEvent* event) {
     if (AInputEvent_getType(event) != AINPUT_EVENT_TYPE_MOTION) return 0;
 
+    // input can arrive before the window is created and after it is destroyed, leave it to the system then
+    PtWindow* window = (PtWindow*)app->userData;
+    if (window == NULL) return 0;
+
+    if (!(window->event_mask & PT_EVENT_MASK_TOUCH)) return 1;
+
     int32_t action = AMotionEvent_getAction(event);
     int32_t pointerIndex = (action & AMOTION_EVENT_ACTION_POINTER_INDEX_MASK) >> AMOTION_EVENT_ACTION_POINTER_INDEX_SHIFT;
     int32_t pointerId = AMotionEvent_getPointerId(event, pointerIndex);
     float x = AMotionEvent_getX(event, pointerIndex);
     float y = AMotionEvent_getY(event, pointerIndex);
 
-    PtWindow* window = (PtWindow*)app->userData;
-    PT_ASSERT(window != NULL);
+    int64_t timestamp = AMotionEvent_getEventTime(event); // CLOCK_MONOTONIC, the same clock as pt_get_time_ns
 
     PtInputEventData ptEvent = pt_create_input_event_data();
+    ptEvent.timestamp = timestamp;
     ptEvent.touch.finger = pointerId;
     ptEvent.touch.x = (int)x;
     ptEvent.touch.y = (int)y;
@@ -415,16 +435,20 @@ int pt_android_handle_input(struct android_app* app, AInputEvent* event) {
     switch (action & AMOTION_EVENT_ACTION_MASK) {
         case AMOTION_EVENT_ACTION_DOWN:
         case AMOTION_EVENT_ACTION_POINTER_DOWN:
+            if (!(window->event_mask & PT_EVENT_MASK_TOUCHDOWN)) return 1;
             ptEvent.type = PT_INPUT_EVENT_TOUCHDOWN;
             break;
         case AMOTION_EVENT_ACTION_UP:
         case AMOTION_EVENT_ACTION_POINTER_UP:
+            if (!(window->event_mask & PT_EVENT_MASK_TOUCHUP)) return 1;
             ptEvent.type = PT_INPUT_EVENT_TOUCHUP;
             break;
         case AMOTION_EVENT_ACTION_MOVE:
+            if (!(window->event_mask & PT_EVENT_MASK_TOUCHMOVE)) return 1;
             ptEvent.type = PT_INPUT_EVENT_TOUCHMOVE;
             for (size_t i = 0; i < AMotionEvent_getPointerCount(event); ++i) {
                 PtInputEventData moveEvent = pt_create_input_event_data();
+                moveEvent.timestamp = timestamp;
                 moveEvent.type = PT_INPUT_EVENT_TOUCHMOVE;
                 moveEvent.touch.finger = AMotionEvent_getPointerId(event, i);
                 moveEvent.touch.x = (int)AMotionEvent_getX(event, i);
@@ -467,7 +491,7 @@ void pt_android_set_native_window(ANativeWindow *native_window, ANativeActivity
 }
 
 void* pt_android_get_handle(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    if (window == NULL) return NULL;
 
     if (android_data && android_data->native_window) {
         return android_data->native_window;
@@ -481,7 +505,6 @@ PtBackend *pt_android_create() {
     backend->type = PT_BACKEND_ANDROID;
     backend->kind = PT_BACKEND_KIND_MOBILE;
     backend->capabilities = PT_CAPABILITY_CREATE_WINDOW;
-    backend->input_event_count = 0;
 
     backend->init = pt_android_init;
     backend->shutdown = pt_android_shutdown;
@@ -489,6 +512,9 @@ PtBackend *pt_android_create() {
     backend->create_window = pt_android_create_window;
     backend->destroy_window = pt_android_destroy_window;
     backend->poll_events = pt_android_poll_events;
+    backend->wait_events = pt_android_wait_events;
+    backend->post_empty_event = pt_android_post_empty_event;
+    backend->get_event_fd = pt_android_get_event_fd;
     backend->swap_buffers = pt_android_swap_buffers;
     backend->set_window_title = pt_android_set_window_title;
     backend->set_window_size = pt_android_set_window_size;
@@ -511,6 +537,8 @@ PtBackend *pt_android_create() {
     backend->is_window_minimized = pt_android_is_window_minimized;
     backend->is_window_focused = pt_android_is_window_focused;
     backend->is_window_visible = pt_android_is_window_visible;
+    backend->set_event_mask = pt_android_set_event_mask;
+    backend->set_relative_mouse_mode = pt_android_set_relative_mouse_mode;
     backend->use_gl_context = pt_android_use_gl_context;
     backend->should_window_close = pt_android_should_window_close;
 
@@ -529,10 +557,13 @@ void pt_android_shutdown(PtBackend *backend) {
     PT_ASSERT(backend != NULL);
 }
 
-PtWindow* pt_android_create_window(const char *title, int width, int height, PtWindowFlags flags) {
+PtWindow* pt_android_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags) {
     PT_ASSERT(title != NULL);
 
-    PtWindow *window = PT_ALLOC(PtWindow);
+    PtWindow *window = pt_alloc_window(context, 0);
+    if (window == NULL) {
+        return NULL;
+    }
 
     if (android_data == NULL) {
         android_data = PT_ALLOC(PtAndroidData);
@@ -549,8 +580,8 @@ PtWindow* pt_android_create_window(const char *title, int width, int height, PtW
     window->handle = android_data;
     window->throttle_enabled = PT_FALSE;
     window->target_fps = 60;
-    window->last_frame_time = 0.0;
-    window->frame_duration = 1.0 / 60.0;
+    window->frame_deadline = 0;
+    window->frame_duration_ns = 1000000000LL / 60;
 
     pt_internal_android_app->userData = window;
 
@@ -560,19 +591,51 @@ PtWindow* pt_android_create_window(const char *title, int width, int height, PtW
 void pt_android_destroy_window(PtWindow *window) {
     PT_ASSERT(window != NULL);
 
-    PT_FREE(window);
+    // also runs when pt_create_context_window fails after the backend made the window
+    if (pt_internal_android_app->userData == window) {
+        pt_internal_android_app->userData = NULL;
+    }
+
+    pt_free_window(window);
 }
 
 void pt_android_poll_events(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    if (window == NULL) return;
+
+    if (android_data && android_data->activity) {
+        pt_android_internal_poll();
+    }
+}
+
+void pt_android_wait_events(PtWindow *window, double timeout) {
+    if (window == NULL) return;
 
     if (android_data && android_data->activity) {
+        int events;
+        struct android_poll_source* source;
+        int timeout_ms = timeout < 0.0 ? -1 : (int)(timeout * 1000.0);
+
+        if (ALooper_pollOnce(timeout_ms, NULL, &events, (void**)&source) >= 0 && source != NULL) {
+            source->process(pt_internal_android_app, source);
+        }
+
         pt_android_internal_poll();
     }
 }
 
+// window events arrive through the looper, which pt_wait does not watch
+int pt_android_get_event_fd(PtWindow *window) {
+    return -1;
+}
+
+void pt_android_post_empty_event(PtBackend *backend) {
+    if (pt_internal_android_app) {
+        ALooper_wake(pt_internal_android_app->looper);
+    }
+}
+
 void pt_android_swap_buffers(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    if (window == NULL) return;
 
     if (android_data) {
         if (android_data->display != EGL_NO_DISPLAY && android_data->surface != EGL_NO_SURFACE) {
@@ -605,7 +668,7 @@ void pt_android_swap_buffers(PtWindow *window) {
 }
 
 PT_BOOL pt_android_should_window_close(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         return android_data->should_close;
@@ -615,7 +678,7 @@ PT_BOOL pt_android_should_window_close(PtWindow *window) {
 }
 
 PT_BOOL pt_android_use_gl_context(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data && android_data->display != EGL_NO_DISPLAY &&
         android_data->context != EGL_NO_CONTEXT &&
@@ -642,7 +705,7 @@ void pt_android_set_should_close(int should_close) {
 }
 
 int pt_android_get_window_width(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->display_width > 0) {
@@ -658,7 +721,7 @@ int pt_android_get_window_width(PtWindow *window) {
 }
 
 int pt_android_get_window_height(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->display_height > 0) {
@@ -781,7 +844,7 @@ static void pt_android_get_display_cutout_info() {
 }
 
 int pt_android_get_usable_framebuffer_width(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->usable_width == 0) {
@@ -794,7 +857,7 @@ int pt_android_get_usable_framebuffer_width(PtWindow *window) {
 }
 
 int pt_android_get_usable_framebuffer_height(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->usable_height == 0) {
@@ -807,7 +870,7 @@ int pt_android_get_usable_framebuffer_height(PtWindow *window) {
 }
 
 int pt_android_get_usable_framebuffer_xoffset(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->usable_width == 0) {
@@ -820,7 +883,7 @@ int pt_android_get_usable_framebuffer_xoffset(PtWindow *window) {
 }
 
 int pt_android_get_usable_framebuffer_yoffset(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
     if (android_data) {
         if (android_data->usable_height == 0) {
@@ -881,21 +944,31 @@ void pt_android_focus_window(PtWindow *window) {
 }
 
 PT_BOOL pt_android_is_window_maximized(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     return PT_TRUE; // sane default
 }
 
 PT_BOOL pt_android_is_window_minimized(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     return PT_FALSE; // sane default
 }
 
 PT_BOOL pt_android_is_window_focused(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     return PT_TRUE; // sane default
 }
 
 PT_BOOL pt_android_is_window_visible(PtWindow *window) {
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     return PT_TRUE; // sane default
 }
+
+void pt_android_set_event_mask(PtWindow *window, PtEventMask mask) {
+    PT_ASSERT(window != NULL);
+    // nothing to unregister, pt_android_handle_input checks window->event_mask
+}
+
+PT_BOOL pt_android_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled) {
+    PT_ASSERT(window != NULL);
+    return PT_FALSE; // unsupported
+}
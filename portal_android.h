@@ -18,9 +18,12 @@ PT_BOOL pt_android_init(PtBackend *backend, PtConfig *config);
 void pt_android_shutdown(PtBackend *backend);
 
 // window
-PtWindow* pt_android_create_window(const char *title, int width, int height, PtWindowFlags flags);
+PtWindow* pt_android_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags);
 void pt_android_destroy_window(PtWindow *window);
 void pt_android_poll_events(PtWindow *window);
+void pt_android_wait_events(PtWindow *window, double timeout);
+void pt_android_post_empty_event(PtBackend *backend);
+int pt_android_get_event_fd(PtWindow *window);
 void pt_android_swap_buffers(PtWindow *window);
 void pt_android_set_window_title(PtWindow *window, const char *title);
 void pt_android_set_window_size(PtWindow *window, int width, int height);
@@ -62,6 +65,10 @@ PT_BOOL pt_android_is_window_minimized(PtWindow *window);
 PT_BOOL pt_android_is_window_focused(PtWindow *window);
 PT_BOOL pt_android_is_window_visible(PtWindow *window);
 
+// input
+void pt_android_set_event_mask(PtWindow *window, PtEventMask mask);
+PT_BOOL pt_android_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled);
+
 #ifdef __cplusplus
 }
 #endif
@@ -1,15 +1,29 @@
 #include "portal_glfw.h"
 #include "portal.h"
 #include "glfw/include/GLFW/glfw3.h"
+
+// pt_wait needs the display connection, define PT_GLFW_X11 and/or PT_GLFW_WAYLAND to expose it
+#ifdef PT_GLFW_X11
+#define GLFW_EXPOSE_NATIVE_X11
+#endif
+#ifdef PT_GLFW_WAYLAND
+#define GLFW_EXPOSE_NATIVE_WAYLAND
+#endif
+#if defined(PT_GLFW_X11) || defined(PT_GLFW_WAYLAND)
+#include "glfw/include/GLFW/glfw3native.h"
+#endif
 #include <stdio.h>
 #include <stdlib.h>
+#include <stdatomic.h>
+
+// GLFW state and callbacks are process wide, a second context would share them and glfwTerminate
+static atomic_int pt_glfw_context_count = 0;
 
 PtBackend *pt_glfw_create() {
     PtBackend *backend = PT_ALLOC(PtBackend);
     backend->type = PT_BACKEND_GLFW;
-    backend->capabilities = PT_CAPABILITY_CREATE_WINDOW | PT_CAPABILITY_WINDOW_SIZE | PT_CAPABILITY_WINDOW_VIDEO_MODE;
+    backend->capabilities = PT_CAPABILITY_CREATE_WINDOW | PT_CAPABILITY_WINDOW_SIZE | PT_CAPABILITY_WINDOW_VIDEO_MODE | PT_CAPABILITY_RELATIVE_MOUSE;
     backend->kind = PT_BACKEND_KIND_DESKTOP;
-    backend->input_event_count = 0;
 
     backend->init = pt_glfw_init;
     backend->shutdown = pt_glfw_shutdown;
@@ -17,6 +31,9 @@ PtBackend *pt_glfw_create() {
     backend->create_window = pt_glfw_create_window;
     backend->destroy_window = pt_glfw_destroy_window;
     backend->poll_events = pt_glfw_poll_events;
+    backend->wait_events = pt_glfw_wait_events;
+    backend->post_empty_event = pt_glfw_post_empty_event;
+    backend->get_event_fd = pt_glfw_get_event_fd;
     backend->swap_buffers = pt_glfw_swap_buffers;
     backend->set_window_title = pt_glfw_set_window_title;
     backend->set_window_size = pt_glfw_set_window_size;
@@ -39,6 +56,8 @@ PtBackend *pt_glfw_create() {
     backend->is_window_minimized = pt_glfw_is_window_minimized;
     backend->is_window_focused = pt_glfw_is_window_focused;
     backend->is_window_visible = pt_glfw_is_window_visible;
+    backend->set_event_mask = pt_glfw_set_event_mask;
+    backend->set_relative_mouse_mode = pt_glfw_set_relative_mouse_mode;
     backend->use_gl_context = pt_glfw_use_gl_context;
     backend->should_window_close = pt_glfw_should_window_close;
 
@@ -49,7 +68,14 @@ PT_BOOL pt_glfw_init(PtBackend *backend, PtConfig *config) {
     PT_ASSERT(config != NULL);
     PT_ASSERT(backend != NULL);
 
+    int expected = 0;
+    if (!atomic_compare_exchange_strong(&pt_glfw_context_count, &expected, 1)) {
+        PT_ASSERT_WARN(PT_FALSE, "the GLFW backend supports one context per process");
+        return PT_FALSE;
+    }
+
     if (!glfwInit()) {
+        atomic_store(&pt_glfw_context_count, 0);
         return PT_FALSE;
     }
 
@@ -60,9 +86,10 @@ void pt_glfw_shutdown(PtBackend *backend) {
     PT_ASSERT(backend != NULL);
 
     glfwTerminate();
+    atomic_store(&pt_glfw_context_count, 0);
 }
 
-PtWindow* pt_glfw_create_window(const char *title, int width, int height, PtWindowFlags flags) {
+PtWindow* pt_glfw_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags) {
     PT_ASSERT(title != NULL);
 
     glfwDefaultWindowHints();
@@ -117,13 +144,25 @@ PtWindow* pt_glfw_create_window(const char *title, int width, int height, PtWind
         window_y = (mode->height - height) / 2;
     }
 
-    PtWindow *window = PT_ALLOC(PtWindow);
-    PtGlfwHandle *handle = PT_ALLOC(PtGlfwHandle);
-    
+    PtWindow *window = pt_alloc_window(context, sizeof(PtGlfwHandle));
+    if (window == NULL) {
+        return NULL;
+    }
+
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+
     handle->glfw = glfwCreateWindow(width, height, title, monitor, NULL);
+    if (handle->glfw == NULL) {
+        pt_free_window(window);
+        return NULL;
+    }
+
     handle->window_width = width;
     handle->window_height = height;
     handle->vsync_enabled = (flags & PT_FLAG_VSYNC) != 0;
+    handle->cursor_x = 0.0;
+    handle->cursor_y = 0.0;
+    handle->cursor_known = PT_FALSE;
 
     if (!monitor && ((flags & PT_FLAG_CENTERED) || (flags & PT_FLAG_BORDERLESS))) {
         glfwSetWindowPos((GLFWwindow*)handle->glfw, window_x, window_y);
@@ -134,38 +173,84 @@ PtWindow* pt_glfw_create_window(const char *title, int width, int height, PtWind
     }
 
     glfwGetFramebufferSize((GLFWwindow*)handle->glfw, &handle->framebuffer_width, &handle->framebuffer_height);
-    
-    window->handle = handle;
+
     window->throttle_enabled = PT_FALSE;
     window->target_fps = 60;
-    window->last_frame_time = 0.0;
-    window->frame_duration = 1.0 / 60.0;
+    window->frame_deadline = 0;
+    window->frame_duration_ns = 1000000000LL / 60;
 
     glfwSetWindowUserPointer((GLFWwindow*)handle->glfw, window);
-    glfwSetMouseButtonCallback((GLFWwindow*)handle->glfw, (GLFWmousebuttonfun)pt_glfw_cb_mouse_button);
-    glfwSetCursorPosCallback((GLFWwindow*)handle->glfw, (GLFWcursorposfun)pt_glfw_cb_mouse_move);
-    glfwSetScrollCallback((GLFWwindow*)handle->glfw, (GLFWscrollfun)pt_glfw_cb_mouse_scroll);
-    glfwSetKeyCallback((GLFWwindow*)handle->glfw, (GLFWkeyfun)pt_glfw_cb_key);
-    glfwSetCharCallback((GLFWwindow*)handle->glfw, (GLFWcharfun)pt_glfw_cb_char);
+    pt_glfw_set_event_mask(window, PT_EVENT_MASK_ALL);
     glfwSetWindowSizeCallback((GLFWwindow*)handle->glfw, (GLFWwindowsizefun)pt_glfw_cb_window_size);
     glfwSetFramebufferSizeCallback((GLFWwindow*)handle->glfw, (GLFWframebuffersizefun)pt_glfw_cb_framebuffer_size);
+    glfwSetWindowIconifyCallback((GLFWwindow*)handle->glfw, (GLFWwindowiconifyfun)pt_glfw_cb_window_iconify);
+    glfwSetWindowFocusCallback((GLFWwindow*)handle->glfw, (GLFWwindowfocusfun)pt_glfw_cb_window_focus);
+
+    // GLFW has no visibility callback, hidden is tracked through pt_glfw_show_window and pt_glfw_hide_window
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_ICONIFIED));
+    pt_set_background_state(window, PT_BACKGROUND_APP_HIDDEN, !glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_VISIBLE));
+    pt_set_background_state(window, PT_BACKGROUND_UNFOCUSED, !glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_FOCUSED));
 
-    PT_ASSERT(handle->glfw != NULL);
     return window;
 }
 
 void* pt_glfw_get_handle(PtWindow *window) {
+    PT_ASSERT_DEBUG(window->handle != NULL);
+
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+    return handle->glfw;
+}
+
+PT_BOOL pt_glfw_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(window->handle != NULL);
+
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+    GLFWwindow *glfw_window = (GLFWwindow*)handle->glfw;
+
+    // a disabled cursor reports virtual, unbounded positions, raw motion skips OS acceleration where supported
+    glfwSetInputMode(glfw_window, GLFW_CURSOR, enabled ? GLFW_CURSOR_DISABLED : GLFW_CURSOR_NORMAL);
+    if (glfwRawMouseMotionSupported()) {
+        glfwSetInputMode(glfw_window, GLFW_RAW_MOUSE_MOTION, enabled ? GLFW_TRUE : GLFW_FALSE);
+    }
+
+    // the cursor jumps when switching, do not report that as movement
+    handle->cursor_known = PT_FALSE;
+    return PT_TRUE;
+}
+
+void pt_glfw_set_event_mask(PtWindow *window, PtEventMask mask) {
+    PT_ASSERT(window != NULL);
     PT_ASSERT(window->handle != NULL);
 
-    return NULL;
+    // a callback nobody listens to is not registered at all, so GLFW never calls into portal for it
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+    GLFWwindow *glfw_window = (GLFWwindow*)handle->glfw;
+    glfwSetMouseButtonCallback(glfw_window, (mask & (PT_EVENT_MASK_MOUSEUP | PT_EVENT_MASK_MOUSEDOWN)) ? (GLFWmousebuttonfun)pt_glfw_cb_mouse_button : NULL);
+    glfwSetCursorPosCallback(glfw_window, (mask & PT_EVENT_MASK_MOUSEMOVE) ? (GLFWcursorposfun)pt_glfw_cb_mouse_move : NULL);
+    if (!(mask & PT_EVENT_MASK_MOUSEMOVE)) {
+        // the tracked position goes stale, the next move after re-enabling must not report the whole jump
+        handle->cursor_known = PT_FALSE;
+    }
+    glfwSetScrollCallback(glfw_window, (mask & PT_EVENT_MASK_MOUSEWHEEL) ? (GLFWscrollfun)pt_glfw_cb_mouse_scroll : NULL);
+    glfwSetKeyCallback(glfw_window, (mask & (PT_EVENT_MASK_KEYUP | PT_EVENT_MASK_KEYDOWN | PT_EVENT_MASK_KEYPRESS)) ? (GLFWkeyfun)pt_glfw_cb_key : NULL);
+    glfwSetCharCallback(glfw_window, (mask & PT_EVENT_MASK_TEXT) ? (GLFWcharfun)pt_glfw_cb_char : NULL);
 }
 
 void pt_glfw_cb_mouse_button(GLFWwindow *glfw_window, int button, int action) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    int64_t timestamp = pt_get_time_ns();
+
+    PtInputEventType type = action == GLFW_PRESS ? PT_INPUT_EVENT_MOUSEDOWN : PT_INPUT_EVENT_MOUSEUP;
+    if (!(window->event_mask & (1 << pt_get_input_event_type_index(type)))) {
+        return;
+    }
 
     PtInputEventData event = pt_create_input_event_data();
-    event.type = action == GLFW_PRESS ? PT_INPUT_EVENT_MOUSEDOWN : PT_INPUT_EVENT_MOUSEUP;
+    event.timestamp = timestamp;
+    event.type = type;
     event.mouse.button = button;
 
     pt_push_input_event(window, event);
@@ -173,54 +258,93 @@ void pt_glfw_cb_mouse_button(GLFWwindow *glfw_window, int button, int action) {
 
 void pt_glfw_cb_mouse_move(GLFWwindow *glfw_window, double x, double y) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    int64_t timestamp = pt_get_time_ns();
+
+    // the delta is taken in double precision, before narrowing to float
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+    double dx = handle->cursor_known ? x - handle->cursor_x : 0.0;
+    double dy = handle->cursor_known ? y - handle->cursor_y : 0.0;
+    handle->cursor_x = x;
+    handle->cursor_y = y;
+    handle->cursor_known = PT_TRUE;
 
     PtInputEventData event = pt_create_input_event_data();
+    event.timestamp = timestamp;
     event.type = PT_INPUT_EVENT_MOUSEMOVE;
-    event.mouse.x = x;
-    event.mouse.y = y;
+    event.mouse.x = (float)x;
+    event.mouse.y = (float)y;
+    event.mouse.dx = (float)dx;
+    event.mouse.dy = (float)dy;
 
     pt_push_input_event(window, event);
 }
 
 void pt_glfw_cb_mouse_scroll(GLFWwindow *glfw_window, double x, double y) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    int64_t timestamp = pt_get_time_ns();
+
+    // fractional trackpad offsets are kept as they are
+    PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
+    double cursor_x = handle->cursor_x;
+    double cursor_y = handle->cursor_y;
+    if (!handle->cursor_known) {
+        // no move callback has run since the position went stale, ask GLFW
+        glfwGetCursorPos(glfw_window, &cursor_x, &cursor_y);
+    }
 
     PtInputEventData event = pt_create_input_event_data();
+    event.timestamp = timestamp;
     event.type = PT_INPUT_EVENT_MOUSEWHEEL;
-    event.mouse.x = x;
-    event.mouse.y = y;
+    event.mouse.x = (float)cursor_x;
+    event.mouse.y = (float)cursor_y;
+    event.mouse.dx = (float)x;
+    event.mouse.dy = (float)y;
 
     pt_push_input_event(window, event);
 }
 
 void pt_glfw_cb_key(GLFWwindow *glfw_window, int key, int scancode, int action) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
 
-    PtInputEventData event = pt_create_input_event_data();
-    event.type = action == GLFW_PRESS ? PT_INPUT_EVENT_KEYDOWN : (action == GLFW_RELEASE ? PT_INPUT_EVENT_KEYUP : PT_INPUT_EVENT_KEYPRESS);
-    event.key.key = key;
-    event.key.modifiers = scancode;
+    int64_t timestamp = pt_get_time_ns();
 
     // keydown and keypress go together
-    if (action == GLFW_PRESS) {
+    if (action == GLFW_PRESS && (window->event_mask & PT_EVENT_MASK_KEYPRESS)) {
         PtInputEventData secondary_event = pt_create_input_event_data();
+        secondary_event.timestamp = timestamp;
         secondary_event.type = PT_INPUT_EVENT_KEYPRESS;
         secondary_event.key.key = key;
         secondary_event.key.modifiers = glfwGetKeyScancode(key);
         pt_push_input_event(window, secondary_event);
     }
 
+    PtInputEventType type = action == GLFW_PRESS ? PT_INPUT_EVENT_KEYDOWN : (action == GLFW_RELEASE ? PT_INPUT_EVENT_KEYUP : PT_INPUT_EVENT_KEYPRESS);
+    if (!(window->event_mask & (1 << pt_get_input_event_type_index(type)))) {
+        return;
+    }
+
+    PtInputEventData event = pt_create_input_event_data();
+    event.timestamp = timestamp;
+    event.type = type;
+    event.key.key = key;
+    event.key.modifiers = scancode;
+
     pt_push_input_event(window, event);
 }
 
 void pt_glfw_cb_char(GLFWwindow *glfw_window, unsigned int codepoint) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    int64_t timestamp = pt_get_time_ns();
 
     PtInputEventData event = pt_create_input_event_data();
+    event.timestamp = timestamp;
     event.type = PT_INPUT_EVENT_TEXT;
     event.text.codepoint = codepoint;
 
@@ -229,16 +353,30 @@ void pt_glfw_cb_char(GLFWwindow *glfw_window, unsigned int codepoint) {
 
 void pt_glfw_cb_window_size(GLFWwindow *glfw_window, int width, int height) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     handle->window_width = width;
     handle->window_height = height;
 }
 
+void pt_glfw_cb_window_iconify(GLFWwindow *glfw_window, int iconified) {
+    PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, iconified == GLFW_TRUE);
+}
+
+void pt_glfw_cb_window_focus(GLFWwindow *glfw_window, int focused) {
+    PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
+    PT_ASSERT_DEBUG(window != NULL);
+
+    pt_set_background_state(window, PT_BACKGROUND_UNFOCUSED, focused != GLFW_TRUE);
+}
+
 void pt_glfw_cb_framebuffer_size(GLFWwindow *glfw_window, int width, int height) {
     PtWindow *window = (PtWindow*)glfwGetWindowUserPointer(glfw_window);
-    PT_ASSERT(window != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
     
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     handle->framebuffer_width = width;
@@ -250,32 +388,63 @@ void pt_glfw_destroy_window(PtWindow *window) {
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     glfwDestroyWindow((GLFWwindow*)handle->glfw);
-    PT_FREE(handle);
-    PT_FREE(window);
+    pt_free_window(window);
 }
 
 void pt_glfw_poll_events(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     glfwPollEvents();
 }
 
+void pt_glfw_wait_events(PtWindow *window, double timeout) {
+    PT_ASSERT_DEBUG(window->handle != NULL);
+
+    if (timeout < 0.0) {
+        glfwWaitEvents();
+    } else if (timeout > 0.0) {
+        glfwWaitEventsTimeout(timeout);
+    } else {
+        glfwPollEvents();
+    }
+}
+
+void pt_glfw_post_empty_event(PtBackend *backend) {
+    glfwPostEmptyEvent();
+}
+
+int pt_glfw_get_event_fd(PtWindow *window) {
+    #ifdef PT_GLFW_WAYLAND
+        if (glfwGetPlatform() == GLFW_PLATFORM_WAYLAND) {
+            return wl_display_get_fd(glfwGetWaylandDisplay());
+        }
+    #endif
+
+    #ifdef PT_GLFW_X11
+        if (glfwGetPlatform() == GLFW_PLATFORM_X11) {
+            return ConnectionNumber(glfwGetX11Display());
+        }
+    #endif
+
+    return -1;
+}
+
 void pt_glfw_swap_buffers(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     glfwSwapBuffers((GLFWwindow*)handle->glfw);
 }
 
 PT_BOOL pt_glfw_should_window_close(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return glfwWindowShouldClose((GLFWwindow*)handle->glfw);
 }
 
 PT_BOOL pt_glfw_use_gl_context(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     glfwMakeContextCurrent((GLFWwindow*)handle->glfw);
@@ -285,28 +454,28 @@ PT_BOOL pt_glfw_use_gl_context(PtWindow *window) {
 }
 
 int pt_glfw_get_window_width(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return handle->window_width;
 }
 
 int pt_glfw_get_window_height(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return handle->window_height;
 }
 
 int pt_glfw_get_framebuffer_width(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return handle->framebuffer_width;
 }
 
 int pt_glfw_get_framebuffer_height(PtWindow *window) {
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return handle->framebuffer_height;
@@ -379,6 +548,7 @@ void pt_glfw_show_window(PtWindow *window) {
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     glfwShowWindow((GLFWwindow*)handle->glfw);
+    pt_set_background_state(window, PT_BACKGROUND_APP_HIDDEN, PT_FALSE);
 }
 
 void pt_glfw_hide_window(PtWindow *window) {
@@ -387,6 +557,7 @@ void pt_glfw_hide_window(PtWindow *window) {
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     glfwHideWindow((GLFWwindow*)handle->glfw);
+    pt_set_background_state(window, PT_BACKGROUND_APP_HIDDEN, PT_TRUE);
 }
 
 void pt_glfw_minimize_window(PtWindow *window) {
@@ -422,32 +593,32 @@ void pt_glfw_focus_window(PtWindow *window) {
 }
 
 PT_BOOL pt_glfw_is_window_maximized(PtWindow *window) {
-    PT_ASSERT(window != NULL);
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_MAXIMIZED);
 }
 
 PT_BOOL pt_glfw_is_window_minimized(PtWindow *window) {
-    PT_ASSERT(window != NULL);
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_ICONIFIED);
 }
 
 PT_BOOL pt_glfw_is_window_focused(PtWindow *window) {
-    PT_ASSERT(window != NULL);
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_FOCUSED);
 }
 
 PT_BOOL pt_glfw_is_window_visible(PtWindow *window) {
-    PT_ASSERT(window != NULL);
-    PT_ASSERT(window->handle != NULL);
+    PT_ASSERT_DEBUG(window != NULL);
+    PT_ASSERT_DEBUG(window->handle != NULL);
 
     PtGlfwHandle *handle = (PtGlfwHandle*)window->handle;
     return glfwGetWindowAttrib((GLFWwindow*)handle->glfw, GLFW_VISIBLE);
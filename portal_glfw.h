@@ -20,6 +20,9 @@ typedef struct {
     int framebuffer_width;
     int framebuffer_height;
     PT_BOOL vsync_enabled;
+    double cursor_x; // last reported position, MOUSEMOVE deltas are taken from it
+    double cursor_y;
+    PT_BOOL cursor_known;
 } PtGlfwHandle;
 
 // creation / destruction
@@ -28,9 +31,12 @@ PT_BOOL pt_glfw_init(PtBackend *backend, PtConfig *config);
 void pt_glfw_shutdown(PtBackend *backend);
 
 // window
-PtWindow* pt_glfw_create_window(const char *title, int width, int height, PtWindowFlags flags);
+PtWindow* pt_glfw_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags);
 void pt_glfw_destroy_window(PtWindow *window);
 void pt_glfw_poll_events(PtWindow *window);
+void pt_glfw_wait_events(PtWindow *window, double timeout);
+void pt_glfw_post_empty_event(PtBackend *backend);
+int pt_glfw_get_event_fd(PtWindow *window);
 void pt_glfw_swap_buffers(PtWindow *window);
 void pt_glfw_set_window_title(PtWindow *window, const char *title);
 void pt_glfw_set_window_size(PtWindow *window, int width, int height);
@@ -56,6 +62,10 @@ PT_BOOL pt_glfw_is_window_minimized(PtWindow *window);
 PT_BOOL pt_glfw_is_window_focused(PtWindow *window);
 PT_BOOL pt_glfw_is_window_visible(PtWindow *window);
 
+// input
+void pt_glfw_set_event_mask(PtWindow *window, PtEventMask mask);
+PT_BOOL pt_glfw_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled);
+
 // callbacks
 void pt_glfw_cb_mouse_button(GLFWwindow *glfw_window, int button, int action);
 void pt_glfw_cb_mouse_move(GLFWwindow *glfw_window, double x, double y);
@@ -64,6 +74,8 @@ void pt_glfw_cb_key(GLFWwindow *glfw_window, int key, int scancode, int action);
 void pt_glfw_cb_char(GLFWwindow *glfw_window, unsigned int codepoint);
 void pt_glfw_cb_window_size(GLFWwindow *glfw_window, int width, int height);
 void pt_glfw_cb_framebuffer_size(GLFWwindow *glfw_window, int width, int height);
+void pt_glfw_cb_window_iconify(GLFWwindow *glfw_window, int iconified);
+void pt_glfw_cb_window_focus(GLFWwindow *glfw_window, int focused);
 
 // helper
 int pt_glfw_offset_zero(PtWindow *window);
@@ -1,5 +1,24 @@
+// clock_gettime, pthread_condattr_setclock and madvise are POSIX and BSD, not C11
+#ifndef _WIN32
+#define _DEFAULT_SOURCE
+#endif
+
 #include "portal.h"
+#include "portal_noop.h"
+#include <stdio.h>
 #include <stdlib.h>
+#include <string.h>
+
+#ifdef _WIN32
+#include <windows.h>
+#else
+#include <fcntl.h>
+#include <pthread.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <time.h>
+#include <unistd.h>
+#endif
 
 #define NOOP_WIDTH 0
 #define NOOP_HEIGHT 0
@@ -8,67 +27,332 @@ typedef struct {
     int width;
     int height;
     PT_BOOL should_close;
+    PtBackend *backend;
+
+    // replay, the recording stays mapped and is read in place
+    void *replay_map;
+    size_t replay_size;
+    #ifdef _WIN32
+    HANDLE replay_file;
+    HANDLE replay_mapping;
+    #endif
+    const PtInputEventData *replay_events;
+    int64_t replay_count;
+    int64_t replay_next;
+    PtReplayMode replay_mode;
+    int64_t replay_start;   // pt_get_time_ns when the replay started
+    int64_t replay_origin;  // timestamp of the first recorded event
 } NoopWindow;
 
-static PT_BOOL pt_noop_init(PtBackend *backend, PtConfig *config) {
+// The backend table and the wake-up state of pt_noop_wait_events share one block,
+// so pt_destroy_backend frees both.
+typedef struct {
+    PtBackend backend;
+    #ifdef _WIN32
+    SRWLOCK lock;
+    CONDITION_VARIABLE wake;
+    #else
+    pthread_mutex_t lock;
+    pthread_cond_t wake;
+    #endif
+    PT_BOOL woken;
+} NoopBackend;
+
+PT_BOOL pt_noop_init(PtBackend *backend, PtConfig *config) {
+    NoopBackend *noop = (NoopBackend*)backend;
+    noop->woken = PT_FALSE;
+
+    #ifdef _WIN32
+        InitializeSRWLock(&noop->lock);
+        InitializeConditionVariable(&noop->wake);
+    #else
+        pthread_condattr_t attr;
+        pthread_condattr_init(&attr);
+        #ifndef __APPLE__
+            pthread_condattr_setclock(&attr, CLOCK_MONOTONIC);
+        #endif
+        pthread_mutex_init(&noop->lock, NULL);
+        pthread_cond_init(&noop->wake, &attr);
+        pthread_condattr_destroy(&attr);
+    #endif
+
     return PT_TRUE;
 }
 
-static void pt_noop_shutdown(PtBackend *backend) {}
+void pt_noop_shutdown(PtBackend *backend) {
+    #ifndef _WIN32
+        NoopBackend *noop = (NoopBackend*)backend;
+        pthread_cond_destroy(&noop->wake);
+        pthread_mutex_destroy(&noop->lock);
+    #endif
+}
+
+PtWindow* pt_noop_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags) {
+    PtWindow *window = pt_alloc_window(context, sizeof(NoopWindow));
+    if (window == NULL) {
+        return NULL;
+    }
 
-static PtWindow* pt_noop_create_window(const char *title, int width, int height, PtWindowFlags flags) {
-    NoopWindow *noop = (NoopWindow*)PT_ALLOC(NoopWindow);
+    NoopWindow *noop = (NoopWindow*)window->handle;
     noop->width = (width > 0) ? width : NOOP_WIDTH;
     noop->height = (height > 0) ? height : NOOP_HEIGHT;
     noop->should_close = PT_FALSE;
+    noop->backend = pt_get_context_backend(context);
+    noop->replay_map = NULL;
+    noop->replay_events = NULL;
 
-    PtWindow *window = (PtWindow*)PT_ALLOC(PtWindow);
-    window->handle = noop;
     window->throttle_enabled = PT_FALSE;
     window->target_fps = 60;
-    window->last_frame_time = 0.0;
-    window->frame_duration = 1.0 / 60.0;
+    window->frame_deadline = 0;
+    window->frame_duration_ns = 1000000000LL / 60;
 
     return window;
 }
 
-static void pt_noop_destroy_window(PtWindow *window) {
+void pt_noop_destroy_window(PtWindow *window) {
     if (!window) return;
-    PT_FREE(window->handle);
-    PT_FREE(window);
+    pt_noop_stop_replay(window);
+    pt_free_window(window);
 }
 
-static void pt_noop_poll_events(PtWindow *window) {
+void pt_noop_poll_events(PtWindow *window) {
+    NoopWindow *noop = (NoopWindow*)window->handle;
+    if (noop->replay_events == NULL) {
+        return;
+    }
+
+    // never push more than fits, a replay delays events instead of dropping them so runs stay deterministic
+    int room = pt_get_input_event_capacity(window) - pt_get_input_event_count(window);
+    int64_t now = pt_get_time_ns();
+
+    while (room > 0 && noop->replay_next < noop->replay_count) {
+        PtInputEventData event = noop->replay_events[noop->replay_next];
+
+        if (noop->replay_mode == PT_REPLAY_ORIGINAL_TIMING) {
+            int64_t due = noop->replay_start + (event.timestamp - noop->replay_origin);
+            if (due > now) {
+                break;
+            }
+
+            event.timestamp = due;
+        } else {
+            event.timestamp = now;
+        }
+
+        pt_push_input_event(window, event);
+        noop->replay_next++;
+        room--;
+    }
 }
 
-static void pt_noop_swap_buffers(PtWindow *window) {
+// seconds until the next replayed event is due, negative when nothing is scheduled
+static double pt_noop_next_event_timeout(PtWindow *window) {
+    NoopWindow *noop = (NoopWindow*)window->handle;
+    if (noop->replay_events == NULL || noop->replay_next >= noop->replay_count) {
+        return -1.0;
+    }
+
+    if (noop->replay_mode != PT_REPLAY_ORIGINAL_TIMING) {
+        return 0.0;
+    }
+
+    int64_t due = noop->replay_start + (noop->replay_events[noop->replay_next].timestamp - noop->replay_origin);
+    int64_t remaining = due - pt_get_time_ns();
+    return remaining > 0 ? remaining / 1000000000.0 : 0.0;
 }
 
-static int pt_noop_get_window_width(PtWindow *window) {
+void pt_noop_wait_events(PtWindow *window, double timeout) {
+    NoopBackend *backend = (NoopBackend*)((NoopWindow*)window->handle)->backend;
+
+    // a pending replay event ends the wait like a real one would
+    double replay_timeout = pt_noop_next_event_timeout(window);
+    if (replay_timeout >= 0.0 && (timeout < 0.0 || replay_timeout < timeout)) {
+        timeout = replay_timeout;
+    }
+
+    #ifdef _WIN32
+        AcquireSRWLockExclusive(&backend->lock);
+        if (!backend->woken && timeout != 0.0) {
+            SleepConditionVariableSRW(&backend->wake, &backend->lock, timeout < 0.0 ? INFINITE : (DWORD)(timeout * 1000.0), 0);
+        }
+        backend->woken = PT_FALSE;
+        ReleaseSRWLockExclusive(&backend->lock);
+    #else
+        pthread_mutex_lock(&backend->lock);
+        if (timeout < 0.0) {
+            while (!backend->woken) {
+                pthread_cond_wait(&backend->wake, &backend->lock);
+            }
+        } else if (timeout > 0.0) {
+            struct timespec deadline;
+            #ifdef __APPLE__
+                clock_gettime(CLOCK_REALTIME, &deadline);
+            #else
+                clock_gettime(CLOCK_MONOTONIC, &deadline);
+            #endif
+            int64_t ns = deadline.tv_nsec + (int64_t)(timeout * 1000000000.0);
+            deadline.tv_sec += (time_t)(ns / 1000000000LL);
+            deadline.tv_nsec = (long)(ns % 1000000000LL);
+
+            while (!backend->woken) {
+                if (pthread_cond_timedwait(&backend->wake, &backend->lock, &deadline) != 0) {
+                    break;
+                }
+            }
+        }
+        backend->woken = PT_FALSE;
+        pthread_mutex_unlock(&backend->lock);
+    #endif
+
+    pt_noop_poll_events(window);
+}
+
+int pt_noop_get_event_fd(PtWindow *window) {
+    return -1;
+}
+
+void pt_noop_post_empty_event(PtBackend *backend) {
+    NoopBackend *noop = (NoopBackend*)backend;
+
+    #ifdef _WIN32
+        AcquireSRWLockExclusive(&noop->lock);
+        noop->woken = PT_TRUE;
+        ReleaseSRWLockExclusive(&noop->lock);
+        WakeAllConditionVariable(&noop->wake);
+    #else
+        pthread_mutex_lock(&noop->lock);
+        noop->woken = PT_TRUE;
+        pthread_cond_broadcast(&noop->wake);
+        pthread_mutex_unlock(&noop->lock);
+    #endif
+}
+
+PT_BOOL pt_noop_start_replay(PtWindow *window, const char *path, PtReplayMode mode) {
+    PT_ASSERT(window != NULL);
+    PT_ASSERT(path != NULL);
+
+    pt_noop_stop_replay(window);
+    NoopWindow *noop = (NoopWindow*)window->handle;
+
+    #ifdef _WIN32
+        HANDLE file = CreateFileA(path, GENERIC_READ, FILE_SHARE_READ, NULL, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, NULL);
+        if (file == INVALID_HANDLE_VALUE) {
+            return PT_FALSE;
+        }
+
+        LARGE_INTEGER size;
+        if (!GetFileSizeEx(file, &size) || size.QuadPart < (LONGLONG)sizeof(PtInputRecordingHeader)) {
+            CloseHandle(file);
+            return PT_FALSE;
+        }
+
+        HANDLE mapping = CreateFileMappingA(file, NULL, PAGE_READONLY, 0, 0, NULL);
+        void *map = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : NULL;
+        if (map == NULL) {
+            if (mapping) CloseHandle(mapping);
+            CloseHandle(file);
+            return PT_FALSE;
+        }
+
+        noop->replay_file = file;
+        noop->replay_mapping = mapping;
+        noop->replay_size = (size_t)size.QuadPart;
+    #else
+        int fd = open(path, O_RDONLY);
+        if (fd < 0) {
+            return PT_FALSE;
+        }
+
+        struct stat info;
+        if (fstat(fd, &info) != 0 || info.st_size < (off_t)sizeof(PtInputRecordingHeader)) {
+            close(fd);
+            return PT_FALSE;
+        }
+
+        // the mapping keeps its own reference to the file
+        void *map = mmap(NULL, (size_t)info.st_size, PROT_READ, MAP_PRIVATE, fd, 0);
+        close(fd);
+        if (map == MAP_FAILED) {
+            return PT_FALSE;
+        }
+
+        madvise(map, (size_t)info.st_size, MADV_SEQUENTIAL);
+        noop->replay_size = (size_t)info.st_size;
+    #endif
+
+    noop->replay_map = map;
+
+    const PtInputRecordingHeader *header = (const PtInputRecordingHeader*)map;
+    if (header->magic != PT_INPUT_RECORDING_MAGIC || header->version != PT_INPUT_RECORDING_VERSION || header->event_size != sizeof(PtInputEventData)) {
+        pt_noop_stop_replay(window);
+        return PT_FALSE;
+    }
+
+    noop->replay_events = (const PtInputEventData*)((const char*)map + sizeof(PtInputRecordingHeader));
+    noop->replay_count = (int64_t)((noop->replay_size - sizeof(PtInputRecordingHeader)) / sizeof(PtInputEventData));
+    noop->replay_next = 0;
+    noop->replay_mode = mode;
+    noop->replay_start = pt_get_time_ns();
+    noop->replay_origin = noop->replay_count > 0 ? noop->replay_events[0].timestamp : 0;
+
+    return PT_TRUE;
+}
+
+void pt_noop_stop_replay(PtWindow *window) {
+    PT_ASSERT(window != NULL);
+
+    NoopWindow *noop = (NoopWindow*)window->handle;
+    if (noop->replay_map == NULL) {
+        return;
+    }
+
+    #ifdef _WIN32
+        UnmapViewOfFile(noop->replay_map);
+        CloseHandle(noop->replay_mapping);
+        CloseHandle(noop->replay_file);
+    #else
+        munmap(noop->replay_map, noop->replay_size);
+    #endif
+
+    noop->replay_map = NULL;
+    noop->replay_events = NULL;
+}
+
+PT_BOOL pt_noop_is_replaying(PtWindow *window) {
+    PT_ASSERT_DEBUG(window != NULL);
+
+    NoopWindow *noop = (NoopWindow*)window->handle;
+    return noop->replay_events != NULL && noop->replay_next < noop->replay_count;
+}
+
+void pt_noop_swap_buffers(PtWindow *window) {
+}
+
+int pt_noop_get_window_width(PtWindow *window) {
     NoopWindow *noop = (NoopWindow*)window->handle;
     return noop->width;
 }
 
-static int pt_noop_get_window_height(PtWindow *window) {
+int pt_noop_get_window_height(PtWindow *window) {
     NoopWindow *noop = (NoopWindow*)window->handle;
     return noop->height;
 }
 
-static int pt_noop_get_framebuffer_width(PtWindow *window) {
+int pt_noop_get_framebuffer_width(PtWindow *window) {
     NoopWindow *noop = (NoopWindow*)window->handle;
     return noop->width;
 }
 
-static int pt_noop_get_framebuffer_height(PtWindow *window) {
+int pt_noop_get_framebuffer_height(PtWindow *window) {
     NoopWindow *noop = (NoopWindow*)window->handle;
     return noop->height;
 }
 
-static PT_BOOL pt_noop_use_gl_context(PtWindow *window) {
+PT_BOOL pt_noop_use_gl_context(PtWindow *window) {
     return PT_TRUE;
 }
 
-static PT_BOOL pt_noop_should_window_close(PtWindow *window) {
+PT_BOOL pt_noop_should_window_close(PtWindow *window) {
     NoopWindow *noop = (NoopWindow*)window->handle;
     return noop->should_close;
 }
@@ -77,13 +361,13 @@ int pt_noop_offset_zero(PtWindow *window) {
     return 0;
 }
 
-static void* pt_noop_get_handle(PtWindow *window) {
+void* pt_noop_get_handle(PtWindow *window) {
     return NULL;
 }
 
-static void pt_noop_set_window_title(PtWindow *window, const char *title) {}
+void pt_noop_set_window_title(PtWindow *window, const char *title) {}
 
-static void pt_noop_set_window_size(PtWindow *window, int width, int height) {
+void pt_noop_set_window_size(PtWindow *window, int width, int height) {
     if (!window || !window->handle) return;
 
     NoopWindow *noop = (NoopWindow*)window->handle;
@@ -91,38 +375,47 @@ static void pt_noop_set_window_size(PtWindow *window, int width, int height) {
     noop->height = height;
 }
 
-static void pt_noop_set_video_mode(PtWindow *window, PtVideoMode mode) {}
+void pt_noop_set_video_mode(PtWindow *window, PtVideoMode mode) {}
 
-static void pt_noop_show_window(PtWindow *window) {}
+void pt_noop_show_window(PtWindow *window) {}
 
-static void pt_noop_hide_window(PtWindow *window) {}
+void pt_noop_hide_window(PtWindow *window) {}
 
-static void pt_noop_minimize_window(PtWindow *window) {}
+void pt_noop_minimize_window(PtWindow *window) {}
 
-static void pt_noop_maximize_window(PtWindow *window) {}
+void pt_noop_maximize_window(PtWindow *window) {}
 
-static void pt_noop_restore_window(PtWindow *window) {}
+void pt_noop_restore_window(PtWindow *window) {}
 
-static void pt_noop_focus_window(PtWindow *window) {}
+void pt_noop_focus_window(PtWindow *window) {}
 
-static PT_BOOL pt_noop_is_window_maximized(PtWindow *window) {
+void pt_noop_set_event_mask(PtWindow *window, PtEventMask mask) {}
+
+PT_BOOL pt_noop_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled) {
+    return PT_FALSE; // unsupported
+}
+
+PT_BOOL pt_noop_is_window_maximized(PtWindow *window) {
     return PT_FALSE;
 }
 
-static PT_BOOL pt_noop_is_window_minimized(PtWindow *window) {
+PT_BOOL pt_noop_is_window_minimized(PtWindow *window) {
     return PT_FALSE;
 }
 
-static PT_BOOL pt_noop_is_window_focused(PtWindow *window) {
+PT_BOOL pt_noop_is_window_focused(PtWindow *window) {
     return PT_TRUE; // sane default
 }
 
-static PT_BOOL pt_noop_is_window_visible(PtWindow *window) {
+PT_BOOL pt_noop_is_window_visible(PtWindow *window) {
     return PT_TRUE; // sane default
 }
 
 PtBackend* pt_noop_create() {
-    PtBackend *backend = PT_ALLOC(PtBackend);
+    NoopBackend *noop = PT_ALLOC(NoopBackend);
+    PT_MEMSET(noop, 0, sizeof(NoopBackend));
+
+    PtBackend *backend = &noop->backend;
     backend->type = PT_BACKEND_NOOP;
     backend->capabilities = PT_CAPABILITY_CREATE_WINDOW | PT_CAPABILITY_WINDOW_SIZE;
     backend->kind = PT_BACKEND_KIND_HEADLESS;
@@ -133,6 +426,9 @@ PtBackend* pt_noop_create() {
     backend->create_window = pt_noop_create_window;
     backend->destroy_window = pt_noop_destroy_window;
     backend->poll_events = pt_noop_poll_events;
+    backend->wait_events = pt_noop_wait_events;
+    backend->post_empty_event = pt_noop_post_empty_event;
+    backend->get_event_fd = pt_noop_get_event_fd;
     backend->swap_buffers = pt_noop_swap_buffers;
     backend->set_window_title = pt_noop_set_window_title;
     backend->set_window_size = pt_noop_set_window_size;
@@ -155,6 +451,8 @@ PtBackend* pt_noop_create() {
     backend->is_window_minimized = pt_noop_is_window_minimized;
     backend->is_window_focused = pt_noop_is_window_focused;
     backend->is_window_visible = pt_noop_is_window_visible;
+    backend->set_event_mask = pt_noop_set_event_mask;
+    backend->set_relative_mouse_mode = pt_noop_set_relative_mouse_mode;
     backend->use_gl_context = pt_noop_use_gl_context;
     backend->should_window_close = pt_noop_should_window_close;
 
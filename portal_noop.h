@@ -13,9 +13,12 @@ PT_BOOL pt_noop_init(PtBackend *backend, PtConfig *config);
 void pt_noop_shutdown(PtBackend *backend);
 
 // window
-PtWindow* pt_noop_create_window(const char *title, int width, int height, PtWindowFlags flags);
+PtWindow* pt_noop_create_window(PtContext *context, const char *title, int width, int height, PtWindowFlags flags);
 void pt_noop_destroy_window(PtWindow *window);
 void pt_noop_poll_events(PtWindow *window);
+void pt_noop_wait_events(PtWindow *window, double timeout); // wakes on pt_noop_post_empty_event, the timeout or the next replayed event
+void pt_noop_post_empty_event(PtBackend *backend);
+int pt_noop_get_event_fd(PtWindow *window); // always -1, pt_wait polls noop windows
 void pt_noop_swap_buffers(PtWindow *window);
 void pt_noop_set_window_title(PtWindow *window, const char *title);
 void pt_noop_set_window_size(PtWindow *window, int width, int height);
@@ -47,6 +50,15 @@ PT_BOOL pt_noop_is_window_minimized(PtWindow *window);
 PT_BOOL pt_noop_is_window_focused(PtWindow *window);
 PT_BOOL pt_noop_is_window_visible(PtWindow *window);
 
+// input
+void pt_noop_set_event_mask(PtWindow *window, PtEventMask mask);
+PT_BOOL pt_noop_set_relative_mouse_mode(PtWindow *window, PT_BOOL enabled);
+
+// replay of a recording made with pt_start_input_recording, fed through pt_push_input_event in pt_poll_events
+PT_BOOL pt_noop_start_replay(PtWindow *window, const char *path, PtReplayMode mode);
+void pt_noop_stop_replay(PtWindow *window);
+PT_BOOL pt_noop_is_replaying(PtWindow *window);
+
 #ifdef __cplusplus
 }
 #endif
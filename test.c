@@ -1,13 +1,379 @@
+// Correctness tests, all against the noop backend so they run without a display.
+// cc -pthread test.c portal_noop.c -o portal_test && ./portal_test
 #include "portal.c"
+#include <pthread.h>
+#include <sched.h>
+
+static int test_failures = 0;
+
+#define TEST_CHECK(condition) \
+    do { \
+        if (!(condition)) { \
+            printf("  failed: %s (line %d)\n", #condition, __LINE__); \
+            test_failures++; \
+        } \
+    } while (0)
+
+static PtContext *test_create_context(PtConfig *config) {
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    return pt_create_context(config);
+}
+
+static void test_destroy_context(PtContext *context, PtConfig *config) {
+    pt_destroy_context(context);
+    pt_destroy_backend(config->backend);
+    pt_destroy_config(config);
+}
+
+typedef struct TestAllocatorStats {
+    long long live_bytes;
+    int alloc_count;
+    int fail_at; // the allocation with this count returns NULL, 0 never fails
+} TestAllocatorStats;
+
+static void *test_alloc(size_t size, void *user_data) {
+    TestAllocatorStats *stats = (TestAllocatorStats*)user_data;
+    if (++stats->alloc_count == stats->fail_at) {
+        return NULL;
+    }
+
+    stats->live_bytes += (long long)size;
+    return malloc(size);
+}
+
+static void test_free(void *ptr, size_t size, void *user_data) {
+    TestAllocatorStats *stats = (TestAllocatorStats*)user_data;
+    stats->live_bytes -= (long long)size;
+    free(ptr);
+}
+
+static void test_init_shutdown() {
+    TestAllocatorStats stats = { 0, 0, 0 };
 
-int main() {
     PtConfig *config = pt_create_config();
-    PtBackend *backend = pt_create_backend(PT_BACKEND_GLFW);
+    config->backend = pt_create_backend(PT_BACKEND_NOOP);
+    config->allocator.alloc = test_alloc;
+    config->allocator.free = test_free;
+    config->allocator.user_data = &stats;
+
+    printf("init and shutdown\n");
+    TEST_CHECK(pt_init(config));
+
+    PtWindow *window = pt_create_window("test", 0, 0, PT_FLAG_NONE);
+    TEST_CHECK(window != NULL);
+    for (int i = 0; i < 100; i++) {
+        pt_destroy_window(pt_create_window("test pool", 0, 0, PT_FLAG_NONE));
+    }
 
-    pt_init(config);
+    // the window block comes from the pool, fail the queue and then its ring
+    for (int i = 1; i <= 2; i++) {
+        stats.fail_at = stats.alloc_count + i;
+        PtWindow *failed = pt_create_window("test fail", 0, 0, PT_FLAG_NONE);
+        TEST_CHECK(failed == NULL);
+        if (failed != NULL) {
+            pt_destroy_window(failed);
+        }
+    }
+    stats.fail_at = 0;
+
+    pt_destroy_window(window);
     pt_shutdown();
+    TEST_CHECK(stats.live_bytes == 0);
 
+    pt_destroy_backend(config->backend);
     pt_destroy_config(config);
+}
+
+#define TEST_SPSC_EVENTS 1000000
+
+static void *test_spsc_producer(void *arg) {
+    PtWindow *window = (PtWindow*)arg;
+    int capacity = pt_get_input_event_capacity(window);
+
+    for (int e = 0; e < TEST_SPSC_EVENTS; e++) {
+        PtInputEventData event = pt_create_input_event_data();
+        event.type = PT_INPUT_EVENT_KEYDOWN;
+        event.key.key = e;
+
+        // a full queue drops, wait for the consumer instead so every event is accounted for
+        while (pt_get_input_event_count(window) >= capacity) {
+            sched_yield();
+        }
+
+        pt_push_input_event(window, event);
+    }
+
+    return NULL;
+}
+
+// one thread pushes sequence numbers while this one drains and reads the counters
+static void test_spsc() {
+    static PtInputEventData out[PT_MAX_EVENT_COUNT];
+    PtConfig *config = pt_create_config();
+    config->concurrent_event_queue = PT_TRUE;
+    PtContext *context = test_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "test spsc", 0, 0, PT_FLAG_NONE);
+    pthread_t producer;
+    int expected = 0;
+    PT_BOOL in_order = PT_TRUE;
+    PT_BOOL in_step = PT_TRUE;
+
+    printf("spsc queue, producer and consumer threads\n");
+    pthread_create(&producer, NULL, test_spsc_producer, window);
+
+    while (expected < TEST_SPSC_EVENTS && in_order) {
+        int count = pt_pull_input_events(window, out, PT_MAX_EVENT_COUNT);
+        if (count == 0) {
+            in_step = in_step && pt_get_pushed_event_count(window, PT_INPUT_EVENT_KEYDOWN) >= expected && pt_get_input_state(window)->buttons == 0;
+            sched_yield();
+        }
+
+        for (int e = 0; e < count && in_order; e++) {
+            in_order = out[e].type == PT_INPUT_EVENT_KEYDOWN && out[e].key.key == expected;
+            expected++;
+        }
+    }
+
+    pthread_join(producer, NULL);
+    TEST_CHECK(in_order);
+    TEST_CHECK(in_step);
+    TEST_CHECK(pt_get_pushed_event_count(window, PT_INPUT_EVENT_KEYDOWN) == TEST_SPSC_EVENTS);
+    TEST_CHECK(pt_get_dropped_event_count(window, PT_INPUT_EVENT_KEYDOWN) == 0);
+    TEST_CHECK(pt_is_key_down(window, 0));
+
+    pt_destroy_window(window);
+    test_destroy_context(context, config);
+}
+
+#define TEST_SCHEDULE_FRAMES 100000
+#define TEST_SCHEDULE_DURATION (1000000000LL / 60)
+
+static uint32_t test_random_state = 12345;
+
+static int64_t test_random(int64_t range) {
+    test_random_state = test_random_state * 1664525u + 1013904223u;
+    return (int64_t)(test_random_state >> 8) % range;
+}
+
+// Frames on a simulated clock: 8-14 ms of work, and every sleep wakes up to 500 us late.
+// overrun_every > 0 makes every nth frame take 40 ms.
+static int64_t test_schedule_run(PtFrameOverrunPolicy policy, int overrun_every, int64_t *end_time) {
+    int64_t now = 0;
+    int64_t deadline = TEST_SCHEDULE_DURATION;
+
+    for (int frame = 1; frame <= TEST_SCHEDULE_FRAMES; frame++) {
+        now += (overrun_every > 0 && frame % overrun_every == 0) ? 40000000 : 8000000 + test_random(6000000);
+
+        if (now < deadline) {
+            now = deadline + test_random(500000);
+        }
+
+        deadline = pt_next_frame_deadline(deadline, TEST_SCHEDULE_DURATION, now, policy);
+    }
+
+    *end_time = now;
+    return deadline;
+}
+
+// late wake-ups must not push the frame grid, only skipped slots may move it
+static void test_frame_schedule() {
+    int64_t ideal = (int64_t)(TEST_SCHEDULE_FRAMES + 1) * TEST_SCHEDULE_DURATION;
+    int64_t end_time;
+
+    printf("frame scheduling on a simulated clock\n");
+
+    TEST_CHECK(test_schedule_run(PT_FRAME_OVERRUN_CATCH_UP, 0, &end_time) == ideal);
+    TEST_CHECK(test_schedule_run(PT_FRAME_OVERRUN_CATCH_UP, 100, &end_time) == ideal);
+
+    int64_t deadline = test_schedule_run(PT_FRAME_OVERRUN_SKIP, 100, &end_time);
+    TEST_CHECK(deadline % TEST_SCHEDULE_DURATION == 0);
+    TEST_CHECK(deadline > end_time);
+}
+
+#define TEST_CONTEXT_COUNT 4
+#define TEST_CONTEXT_FRAMES 2000
+
+typedef struct TestContextRun {
+    long long events;
+    PT_BOOL owned;
+} TestContextRun;
+
+// each thread owns a full noop instance, nothing is shared with the other threads
+static void *test_context_thread(void *arg) {
+    TestContextRun *run = (TestContextRun*)arg;
+
+    PtConfig *config = pt_create_config();
+    PtContext *context = test_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "test context", 0, 0, PT_FLAG_NONE);
+
+    run->owned = pt_get_window_context(window) == context;
+    for (int frame = 0; frame < TEST_CONTEXT_FRAMES; frame++) {
+        pt_poll_events(window);
+
+        for (int e = 0; e < 8; e++) {
+            PtInputEventData event = pt_create_input_event_data();
+            event.type = PT_INPUT_EVENT_KEYDOWN;
+            event.key.key = e;
+            pt_push_input_event(window, event);
+        }
+
+        while (pt_get_input_event_count(window) > 0) {
+            pt_pull_input_event(window);
+            run->events++;
+        }
+
+        pt_swap_buffers(window);
+    }
+
+    pt_destroy_window(window);
+    test_destroy_context(context, config);
+
+    return NULL;
+}
+
+static void test_contexts() {
+    pthread_t threads[TEST_CONTEXT_COUNT];
+    TestContextRun runs[TEST_CONTEXT_COUNT];
+
+    printf("independent contexts, one per thread\n");
+    for (int i = 0; i < TEST_CONTEXT_COUNT; i++) {
+        runs[i].events = 0;
+        runs[i].owned = PT_FALSE;
+        pthread_create(&threads[i], NULL, test_context_thread, &runs[i]);
+    }
+
+    for (int i = 0; i < TEST_CONTEXT_COUNT; i++) {
+        pthread_join(threads[i], NULL);
+        TEST_CHECK(runs[i].owned);
+        TEST_CHECK(runs[i].events == (long long)TEST_CONTEXT_FRAMES * 8);
+    }
+}
+
+static void test_background() {
+    PtConfig *config = pt_create_config();
+    config->background_policy = PT_BACKGROUND_THROTTLE;
+    config->background_fps = 100;
+    PtContext *context = test_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "test background", 0, 0, PT_FLAG_NONE);
+    PtFrameStats stats;
+
+    printf("background throttling\n");
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, PT_TRUE);
+    pt_reset_frame_stats(window);
+    for (int i = 0; i < 20; i++) {
+        pt_swap_buffers(window);
+    }
+    pt_get_frame_stats(window, &stats);
+    pt_set_background_state(window, PT_BACKGROUND_MINIMIZED, PT_FALSE);
+    TEST_CHECK(stats.p50 > 0.009);
+
+    // BLOCK must not wait on a window the app hid itself, nothing else would ever show it
+    window->background_policy = PT_BACKGROUND_BLOCK;
+    pt_set_background_state(window, PT_BACKGROUND_APP_HIDDEN, PT_TRUE);
+    int64_t start = pt_get_time_ns();
+    for (int i = 0; i < 3; i++) {
+        pt_swap_buffers(window);
+    }
+    TEST_CHECK(pt_get_time_ns() - start < 1000000000LL);
+    pt_set_background_state(window, PT_BACKGROUND_APP_HIDDEN, PT_FALSE);
+
+    pt_destroy_window(window);
+    test_destroy_context(context, config);
+}
+
+#define TEST_REACTOR_ROUNDS 20
+
+static void *test_reactor_thread(void *arg) {
+    int fd = *(int*)arg;
+    char byte = 1;
+
+    pt_sleep(0.002);
+    if (write(fd, &byte, 1) != 1) {
+        printf("  reactor: pipe write failed\n");
+    }
+
+    return NULL;
+}
+
+static void test_reactor() {
+    PtConfig *config = pt_create_config();
+    PtContext *context = test_create_context(config);
+    PtWindow *window = pt_create_context_window(context, "test reactor", 0, 0, PT_FLAG_NONE);
+    PtWaitResult result;
+    int pipe_fds[2];
+
+    printf("pt_wait reactor\n");
+    if (pipe(pipe_fds) != 0 || !pt_watch_fd(context, pipe_fds[0], PT_FD_READABLE)) {
+        printf("  reactor unavailable, skipped\n");
+        pt_destroy_window(window);
+        test_destroy_context(context, config);
+        return;
+    }
+
+    int64_t start = pt_get_time_ns();
+    PtWakeReason reasons = pt_wait(window, 0.005, &result);
+    TEST_CHECK((reasons & ~PT_WAKE_WINDOW) == 0);
+    TEST_CHECK(pt_get_time_ns() - start >= 5000000);
+
+    pt_post_context_empty_event(context);
+    TEST_CHECK(pt_wait(window, 1.0, &result) & PT_WAKE_EMPTY_EVENT);
+
+    // one post is one wake, whichever wait takes it
+    start = pt_get_time_ns();
+    pt_wait_events(window, 0.005);
+    TEST_CHECK(pt_get_time_ns() - start >= 5000000);
+    pt_post_context_empty_event(context);
+    pt_wait_events(window, 1.0);
+    TEST_CHECK(!(pt_wait(window, 0.005, &result) & PT_WAKE_EMPTY_EVENT));
+
+    // the window throttles in pt_wait, its deadline wake must never come early
+    pt_enable_throttle(window, 250);
+    pt_set_throttle_in_wait(window, PT_TRUE);
+    for (int round = 0; round < TEST_REACTOR_ROUNDS; round++) {
+        pt_swap_buffers(window);
+        do {
+            reasons = pt_wait(window, -1.0, &result);
+        } while (!(reasons & PT_WAKE_DEADLINE));
+        TEST_CHECK(pt_get_time_ns() >= window->frame_deadline);
+    }
+    pt_disable_throttle(window);
+
+    for (int round = 0; round < TEST_REACTOR_ROUNDS; round++) {
+        pthread_t thread;
+        char byte;
+
+        pthread_create(&thread, NULL, test_reactor_thread, &pipe_fds[1]);
+        do {
+            reasons = pt_wait(window, -1.0, &result);
+        } while (!(reasons & PT_WAKE_FD));
+        pthread_join(thread, NULL);
+
+        TEST_CHECK(result.fd_count == 1 && result.fds[0] == pipe_fds[0]);
+        TEST_CHECK(result.fd_events[0] & PT_FD_READABLE);
+        TEST_CHECK(read(pipe_fds[0], &byte, 1) == 1);
+    }
+
+    pt_unwatch_fd(context, pipe_fds[0]);
+    close(pipe_fds[0]);
+    close(pipe_fds[1]);
+
+    pt_destroy_window(window);
+    test_destroy_context(context, config);
+}
+
+int main() {
+    test_init_shutdown();
+    test_spsc();
+    test_frame_schedule();
+    test_contexts();
+    test_background();
+    test_reactor();
+
+    if (test_failures > 0) {
+        printf("%d checks failed\n", test_failures);
+        return 1;
+    }
 
+    printf("all tests passed\n");
     return 0;
-}
\ No newline at end of file
+}